@@ -0,0 +1,181 @@
+#ifndef BROADCAST_RING_HPP
+#define BROADCAST_RING_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <memory>
+#include <utility>
+#include <vector>
+#include "SpscRingBuffer.hpp"
+
+// Disruptor-style broadcast ring: one producer, any number of subscribers, and every
+// subscriber sees every record in order. Slots are constructed once and overwritten in
+// place, records are never moved out, and each subscriber only publishes how far it has
+// read. The producer is held back by the slowest subscriber only, and a subscriber created
+// with dependencies never gets ahead of them, which chains stages into a pipeline
+// (validator -> aggregator) over one ring.
+//
+// Positions count records: record n lives in slot n & mask, the producer's cursor is the
+// number of records published and a subscriber's position the number it has handled.
+// All subscribers must be added before the first publish.
+
+template <typename T>
+class BroadcastRing
+{
+    // Padded so the producer's cursor and each subscriber's position sit on their own line
+    struct alignas(CACHE_LINE_SIZE) Sequence
+    {
+        std::atomic<uint64_t> value{0};
+    };
+
+public:
+    class Subscriber
+    {
+    public:
+        Subscriber(const Subscriber&) = delete;
+        Subscriber& operator=(const Subscriber&) = delete;
+
+        // Calls handler(const T&, uint64_t seq) for up to max_n available records and then
+        // publishes the new position once for the whole batch. Never waits.
+        template <typename Handler>
+        size_t poll(Handler&& handler, size_t max_n = SIZE_MAX)
+        {
+            const uint64_t pos = position.value.load(std::memory_order_relaxed);
+            if (cachedAvailable - pos < max_n)
+            {
+                cachedAvailable = available();
+            }
+            const uint64_t n = std::min<uint64_t>(max_n, cachedAvailable - pos);
+            for (uint64_t seq = pos; seq < pos + n; ++seq)
+            {
+                handler(static_cast<const T&>(ring.slotAt(seq)), seq);
+            }
+            if (n > 0)
+            {
+                position.value.store(pos + n, std::memory_order_release);
+            }
+            return n;
+        }
+
+        // Like poll, but spins and then yields until at least one record is available or
+        // the timeout expires
+        template <typename Rep, typename Period, typename Handler>
+        size_t poll_for(const std::chrono::duration<Rep, Period>& timeout, Handler&& handler,
+                        size_t max_n = SIZE_MAX)
+        {
+            const auto deadline = std::chrono::steady_clock::now() + timeout;
+            for (unsigned spins = 0;; ++spins)
+            {
+                if (size_t n = poll(handler, max_n))
+                {
+                    return n;
+                }
+                if (std::chrono::steady_clock::now() >= deadline)
+                {
+                    return 0;
+                }
+                ring::backoff(spins);
+            }
+        }
+
+        // Number of records this subscriber has finished with
+        uint64_t getPosition(void) const { return position.value.load(std::memory_order_acquire); }
+
+        // Records published but not yet handled by this subscriber (approximate)
+        size_t getLag(void) const { return ring.getPublished() - getPosition(); }
+
+    private:
+        friend class BroadcastRing;
+
+        Subscriber(BroadcastRing &ring, std::vector<const Subscriber*> upstream)
+            : ring(ring), upstream(std::move(upstream)) {}
+
+        // Barrier: a record is readable once the producer published it and every
+        // upstream stage is done with it
+        uint64_t available(void) const
+        {
+            uint64_t limit = ring.cursor.value.load(std::memory_order_acquire);
+            for (const Subscriber *s : upstream)
+            {
+                limit = std::min(limit, s->position.value.load(std::memory_order_acquire));
+            }
+            return limit;
+        }
+
+        Sequence position;
+        BroadcastRing &ring;
+        std::vector<const Subscriber*> upstream;
+        uint64_t cachedAvailable = 0;
+    };
+
+    // Capacity is rounded up to a power of two; every slot is default-constructed now
+    explicit BroadcastRing(size_t len) : mask(ring::roundUpPow2(len) - 1), slots(mask + 1)
+    {
+        assert(len > 0);
+    }
+
+    BroadcastRing(const BroadcastRing&) = delete;
+    BroadcastRing& operator=(const BroadcastRing&) = delete;
+
+    // New subscriber that only sees a record after every subscriber in after has handled it.
+    // Not thread-safe, register all stages before the producer starts.
+    Subscriber& subscribe(std::initializer_list<const Subscriber*> after = {})
+    {
+        subscribers.push_back(std::unique_ptr<Subscriber>(new Subscriber(*this, after)));
+        return *subscribers.back();
+    }
+
+    // Producer side only. fill(T& slot, uint64_t seq) writes the record straight into its
+    // slot, so a payload buffer left there from the previous lap is reused rather than
+    // reallocated. Waits while the slowest subscriber is a full ring behind.
+    template <typename Fill>
+    void publish_with(Fill&& fill)
+    {
+        const uint64_t seq = cursor.value.load(std::memory_order_relaxed);
+        for (unsigned spins = 0; seq - cachedGate > mask; ++spins)
+        {
+            cachedGate = slowestPosition(seq);
+            if (seq - cachedGate > mask)
+            {
+                ring::backoff(spins);
+            }
+        }
+        fill(slotAt(seq), seq);
+        cursor.value.store(seq + 1, std::memory_order_release);
+    }
+
+    void publish(T&& data)
+    {
+        publish_with([&](T &slot, uint64_t) { slot = std::move(data); });
+    }
+
+    uint64_t getPublished(void) const { return cursor.value.load(std::memory_order_acquire); }
+    size_t capacity(void) const { return mask + 1; }
+
+private:
+    Sequence cursor;
+    uint64_t cachedGate = 0;
+    const size_t mask;
+    std::vector<T> slots;
+    std::vector<std::unique_ptr<Subscriber>> subscribers;
+
+    T& slotAt(uint64_t seq) { return slots[seq & mask]; }
+
+    // Every stage gates the producer: a downstream stage may lag its upstream one
+    uint64_t slowestPosition(uint64_t seq) const
+    {
+        uint64_t slowest = seq;
+        for (const auto &s : subscribers)
+        {
+            slowest = std::min(slowest, s->position.value.load(std::memory_order_acquire));
+        }
+        return slowest;
+    }
+};
+
+#endif
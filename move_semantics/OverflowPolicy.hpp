@@ -0,0 +1,40 @@
+#ifndef OVERFLOW_POLICY_HPP
+#define OVERFLOW_POLICY_HPP
+
+#include <chrono>
+#include <cstdint>
+
+// What TelemetryQueue::push_data does when the queue is full. For sensor ingest a stalled
+// producer is usually worse than a lost sample, so everything but Block bounds how long a
+// push can take.
+enum class Overflow {
+    Block,             // wait for room, the default
+    BlockWithTimeout,  // wait at most timeout, then drop the new record
+    DropNewest,        // drop the new record right away
+    DropOldest,        // evict the oldest queued record to make room
+    Sample,            // while full keep every keepEvery-th new record (evicting the oldest), drop the rest
+};
+
+struct OverflowPolicy {
+    Overflow mode = Overflow::Block;
+    std::chrono::nanoseconds timeout{0};
+    uint32_t keepEvery = 1;
+
+    static OverflowPolicy block(void) { return {}; }
+    static OverflowPolicy blockFor(std::chrono::nanoseconds t) { return {Overflow::BlockWithTimeout, t, 1}; }
+    static OverflowPolicy dropNewest(void) { return {Overflow::DropNewest, {}, 1}; }
+    static OverflowPolicy dropOldest(void) { return {Overflow::DropOldest, {}, 1}; }
+    static OverflowPolicy sampleEvery(uint32_t n) { return {Overflow::Sample, {}, n > 0 ? n : 1}; }
+};
+
+// Records lost to backpressure, by cause. Unlike QueueStats these are always counted; they
+// are only touched on the overflow path.
+struct OverflowCounts {
+    uint64_t timed_out = 0;       // BlockWithTimeout push_data and push_until gave up
+    uint64_t dropped_newest = 0;  // DropNewest
+    uint64_t dropped_oldest = 0;  // evicted by DropOldest or a kept Sample
+    uint64_t sampled_out = 0;     // skipped by Sample
+    uint64_t rejected = 0;        // try_push found the queue full
+};
+
+#endif
@@ -0,0 +1,91 @@
+#ifndef PAYLOAD_POOL_HPP
+#define PAYLOAD_POOL_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "SpscRingBuffer.hpp"
+
+// Recycles payload buffers from the consumer back to the producer so a moved-out
+// Telemetry::payload does not cost a fresh allocation on the next record.
+// acquire() and reclaim() must only be called from the producing thread and release() only
+// from the consuming thread; the return channel between them is a lock-free SPSC ring.
+class PayloadPool
+{
+public:
+    // slots should cover everything that can be in flight at once (queue capacity plus
+    // the consumer's batch), otherwise released buffers get dropped and freed.
+    PayloadPool(size_t slots, size_t payloadCapacity) : returned(slots), payloadCapacity(payloadCapacity)
+    {
+        spare.reserve(slots);
+    }
+
+    // Producer side. Returns an empty buffer with at least payloadCapacity reserved.
+    std::vector<std::byte> acquire(void)
+    {
+        if (!spare.empty())
+        {
+            hitCount.fetch_add(1, std::memory_order_relaxed);
+            std::vector<std::byte> buf = std::move(spare.back());
+            spare.pop_back();
+            return buf;
+        }
+        if (auto buf = returned.try_pop())
+        {
+            hitCount.fetch_add(1, std::memory_order_relaxed);
+            return std::move(*buf);
+        }
+        missCount.fetch_add(1, std::memory_order_relaxed);
+        std::vector<std::byte> buf;
+        buf.reserve(payloadCapacity);
+        return buf;
+    }
+
+    // Consumer side. Keeps the buffer's capacity, drops its contents.
+    void release(std::vector<std::byte>&& buf)
+    {
+        if (buf.capacity() < payloadCapacity)
+        {
+            // Moved-from or undersized, recycling it would not save an allocation
+            return;
+        }
+        buf.clear();
+        if (!returned.try_push(std::move(buf)))
+        {
+            dropCount.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    // Producer side, for a buffer that never reached the consumer, e.g. one the queue evicted
+    // on overflow (TelemetryQueue::set_payload_pool). The next acquire() hands it out first.
+    void reclaim(std::vector<std::byte>&& buf)
+    {
+        if (buf.capacity() < payloadCapacity)
+        {
+            return;
+        }
+        if (spare.size() == spare.capacity())
+        {
+            dropCount.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        buf.clear();
+        spare.push_back(std::move(buf));
+    }
+
+    uint64_t hits(void) const { return hitCount.load(std::memory_order_relaxed); }
+    uint64_t misses(void) const { return missCount.load(std::memory_order_relaxed); }
+    uint64_t drops(void) const { return dropCount.load(std::memory_order_relaxed); }
+
+private:
+    SpscRingBuffer<std::vector<std::byte>> returned;
+    // Reclaimed on the producing thread, reserved up front so reclaim() never allocates
+    std::vector<std::vector<std::byte>> spare;
+    size_t payloadCapacity;
+    std::atomic<uint64_t> hitCount{0};
+    std::atomic<uint64_t> missCount{0};
+    std::atomic<uint64_t> dropCount{0};
+};
+
+#endif
@@ -0,0 +1,151 @@
+#ifndef QUEUE_STATS_HPP
+#define QUEUE_STATS_HPP
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+// Optional TelemetryQueue instrumentation, enabled by building with -DTELEMETRY_QUEUE_STATS.
+// Without the define QueueStats is an empty type whose hooks are inline no-ops, so the
+// queue compiles to exactly what it was (not even a clock read remains).
+
+// Plain copy of the counters. Fields are read one by one, so a snapshot taken while the
+// queue is busy can be off by the records in flight between two loads.
+struct QueueStatsSnapshot {
+    static constexpr size_t RESIDENCY_BUCKETS = 32;  // bucket i: [2^(i-1), 2^i) ns
+    static constexpr size_t OCCUPANCY_BUCKETS = 10;  // bucket i: [i*10%, (i+1)*10%) full
+
+    uint64_t pushes = 0;
+    uint64_t pops = 0;
+    uint64_t residency_total_ns = 0;
+    uint64_t residency_max_ns = 0;
+    std::array<uint64_t, RESIDENCY_BUCKETS> residency_hist{};
+    uint64_t producer_blocked_ns = 0;
+    uint64_t producer_blocks = 0;
+    uint64_t consumer_wait_ns = 0;
+    uint64_t consumer_waits = 0;
+    uint64_t occupancy_high_water = 0;
+    std::array<uint64_t, OCCUPANCY_BUCKETS> occupancy_hist{};
+};
+
+#ifdef TELEMETRY_QUEUE_STATS
+
+class QueueStats
+{
+public:
+    using Mark = uint64_t;
+
+    explicit QueueStats(size_t capacity) : capacity(capacity) {}
+
+    // Same clock as Telemetry::timestamp_ns
+    static Mark now(void)
+    {
+        using namespace std::chrono;
+        return duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+    }
+
+    // The hooks below are only called with the queue lock held, so every counter has a
+    // single writer and a relaxed load/store pair is enough; the atomics exist so that a
+    // monitoring thread can read them without the lock.
+    void onPush(size_t occupancy)
+    {
+        bump(pushes);
+        if (occupancy > occupancyHighWater.load(std::memory_order_relaxed))
+        {
+            occupancyHighWater.store(occupancy, std::memory_order_relaxed);
+        }
+        size_t bucket = occupancy * QueueStatsSnapshot::OCCUPANCY_BUCKETS / (capacity + 1);
+        bump(occupancyHist[bucket]);
+    }
+
+    void onPop(uint64_t timestamp_ns)
+    {
+        bump(pops);
+        uint64_t t = now();
+        uint64_t residency = t > timestamp_ns ? t - timestamp_ns : 0;
+        bump(residencyTotal, residency);
+        if (residency > residencyMax.load(std::memory_order_relaxed))
+        {
+            residencyMax.store(residency, std::memory_order_relaxed);
+        }
+        size_t bucket = std::min<size_t>(std::bit_width(residency), QueueStatsSnapshot::RESIDENCY_BUCKETS - 1);
+        bump(residencyHist[bucket]);
+    }
+
+    void onProducerBlocked(Mark since)
+    {
+        bump(producerBlocks);
+        bump(producerBlockedNs, now() - since);
+    }
+
+    void onConsumerWaited(Mark since)
+    {
+        bump(consumerWaits);
+        bump(consumerWaitNs, now() - since);
+    }
+
+    QueueStatsSnapshot snapshot(void) const
+    {
+        QueueStatsSnapshot s;
+        s.pushes = pushes.load(std::memory_order_relaxed);
+        s.pops = pops.load(std::memory_order_relaxed);
+        s.residency_total_ns = residencyTotal.load(std::memory_order_relaxed);
+        s.residency_max_ns = residencyMax.load(std::memory_order_relaxed);
+        for (size_t i = 0; i < s.residency_hist.size(); ++i)
+        {
+            s.residency_hist[i] = residencyHist[i].load(std::memory_order_relaxed);
+        }
+        s.producer_blocked_ns = producerBlockedNs.load(std::memory_order_relaxed);
+        s.producer_blocks = producerBlocks.load(std::memory_order_relaxed);
+        s.consumer_wait_ns = consumerWaitNs.load(std::memory_order_relaxed);
+        s.consumer_waits = consumerWaits.load(std::memory_order_relaxed);
+        s.occupancy_high_water = occupancyHighWater.load(std::memory_order_relaxed);
+        for (size_t i = 0; i < s.occupancy_hist.size(); ++i)
+        {
+            s.occupancy_hist[i] = occupancyHist[i].load(std::memory_order_relaxed);
+        }
+        return s;
+    }
+
+private:
+    size_t capacity;
+    std::atomic<uint64_t> pushes{0};
+    std::atomic<uint64_t> pops{0};
+    std::atomic<uint64_t> residencyTotal{0};
+    std::atomic<uint64_t> residencyMax{0};
+    std::array<std::atomic<uint64_t>, QueueStatsSnapshot::RESIDENCY_BUCKETS> residencyHist{};
+    std::atomic<uint64_t> producerBlockedNs{0};
+    std::atomic<uint64_t> producerBlocks{0};
+    std::atomic<uint64_t> consumerWaitNs{0};
+    std::atomic<uint64_t> consumerWaits{0};
+    std::atomic<uint64_t> occupancyHighWater{0};
+    std::array<std::atomic<uint64_t>, QueueStatsSnapshot::OCCUPANCY_BUCKETS> occupancyHist{};
+
+    static void bump(std::atomic<uint64_t> &counter, uint64_t by = 1)
+    {
+        counter.store(counter.load(std::memory_order_relaxed) + by, std::memory_order_relaxed);
+    }
+};
+
+#else
+
+class QueueStats
+{
+public:
+    struct Mark {};
+    explicit QueueStats(size_t) {}
+    static Mark now(void) { return {}; }
+    void onPush(size_t) {}
+    void onPop(uint64_t) {}
+    void onProducerBlocked(Mark) {}
+    void onConsumerWaited(Mark) {}
+    QueueStatsSnapshot snapshot(void) const { return {}; }
+};
+
+#endif
+
+#endif
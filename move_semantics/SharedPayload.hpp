@@ -0,0 +1,201 @@
+#ifndef SHARED_PAYLOAD_HPP
+#define SHARED_PAYLOAD_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <span>
+#include <utility>
+#include "TopicRegistry.hpp"
+
+// Immutable, reference-counted payload blocks carved out of a slab, for delivering one
+// received blob to several consumers (disk writer, dashboard, downsampler) without copying
+// its bytes. Copying a SharedPayload only bumps a counter; the block goes back to its slab
+// when the last handle is dropped, from whichever thread drops it.
+
+class PayloadSlab;
+
+class SharedPayload
+{
+public:
+    SharedPayload() = default;
+
+    SharedPayload(const SharedPayload& other) noexcept : block(other.block)
+    {
+        if (block)
+        {
+            block->refs.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    SharedPayload(SharedPayload&& other) noexcept : block(std::exchange(other.block, nullptr)) {}
+
+    SharedPayload& operator=(SharedPayload other) noexcept
+    {
+        std::swap(block, other.block);
+        return *this;
+    }
+
+    ~SharedPayload() { reset(); }
+
+    const std::byte* data(void) const { return block ? block->bytes() : nullptr; }
+    size_t size(void) const { return block ? block->size : 0; }
+    bool empty(void) const { return size() == 0; }
+    std::span<const std::byte> bytes(void) const { return {data(), size()}; }
+    uint32_t use_count(void) const { return block ? block->refs.load(std::memory_order_relaxed) : 0; }
+
+    // Only for filling a freshly allocated payload before it is shared
+    std::byte* writable(void)
+    {
+        assert(use_count() == 1);
+        return block->bytes();
+    }
+
+    void reset(void);
+
+private:
+    friend class PayloadSlab;
+
+    // Header in front of every block, padded to a cache line so two blocks' counters
+    // never share one
+    struct alignas(64) Block
+    {
+        std::atomic<uint32_t> refs{1};
+        uint32_t size = 0;
+        PayloadSlab *owner = nullptr;   // null for oversized blocks taken from the heap
+        Block *next = nullptr;          // free-list link while unused
+
+        std::byte* bytes(void) { return reinterpret_cast<std::byte*>(this + 1); }
+    };
+
+    explicit SharedPayload(Block *b) : block(b) {}
+
+    Block *block = nullptr;
+};
+
+class PayloadSlab
+{
+public:
+    // One contiguous allocation holding blockCount blocks of up to blockSize bytes each.
+    // The slab must outlive every SharedPayload allocated from it.
+    PayloadSlab(size_t blockSize, size_t blockCount)
+        : stride(sizeof(Block) + roundUp(blockSize, alignof(Block))), capacity(blockSize),
+          storage(static_cast<std::byte*>(::operator new(stride * blockCount, std::align_val_t(alignof(Block)))))
+    {
+        for (size_t i = 0; i < blockCount; ++i)
+        {
+            Block *b = new (storage.get() + i * stride) Block;
+            b->owner = this;
+            b->next = local;
+            local = b;
+        }
+    }
+
+    PayloadSlab(const PayloadSlab&) = delete;
+    PayloadSlab& operator=(const PayloadSlab&) = delete;
+
+    // Call from one thread only (the producer). Falls back to a heap block when the slab
+    // is exhausted or size exceeds the block size, so it never fails or waits.
+    SharedPayload allocate(size_t size)
+    {
+        Block *b = nullptr;
+        if (size <= capacity)
+        {
+            if (!local)
+            {
+                // Take everything the consumers have released so far in one exchange
+                local = released.exchange(nullptr, std::memory_order_acquire);
+            }
+            b = local;
+        }
+        if (b)
+        {
+            local = b->next;
+            b->refs.store(1, std::memory_order_relaxed);
+            hitCount.fetch_add(1, std::memory_order_relaxed);
+        }
+        else
+        {
+            void *mem = ::operator new(sizeof(Block) + size, std::align_val_t(alignof(Block)));
+            b = new (mem) Block;
+            missCount.fetch_add(1, std::memory_order_relaxed);
+        }
+        b->size = static_cast<uint32_t>(size);
+        return SharedPayload(b);
+    }
+
+    // Allocates and copies bytes in, the one copy a received blob needs
+    SharedPayload copyOf(std::span<const std::byte> bytes)
+    {
+        SharedPayload p = allocate(bytes.size());
+        std::copy(bytes.begin(), bytes.end(), p.writable());
+        return p;
+    }
+
+    uint64_t hits(void) const { return hitCount.load(std::memory_order_relaxed); }
+    uint64_t misses(void) const { return missCount.load(std::memory_order_relaxed); }
+
+private:
+    friend class SharedPayload;
+    using Block = SharedPayload::Block;
+
+    struct AlignedDelete
+    {
+        void operator()(std::byte *p) const { ::operator delete(p, std::align_val_t(alignof(Block))); }
+    };
+
+    size_t stride;
+    size_t capacity;
+    std::unique_ptr<std::byte, AlignedDelete> storage;
+    Block *local = nullptr;                 // allocator thread's private free list
+    std::atomic<Block*> released{nullptr};  // pushed to by any releasing thread
+    std::atomic<uint64_t> hitCount{0};
+    std::atomic<uint64_t> missCount{0};
+
+    static size_t roundUp(size_t n, size_t align)
+    {
+        return (n + align - 1) / align * align;
+    }
+
+    // Lock-free push. Only the allocator ever takes blocks out, and it takes the whole
+    // list at once, so the classic ABA problem of a Treiber stack cannot occur.
+    void recycle(Block *b)
+    {
+        Block *head = released.load(std::memory_order_relaxed);
+        do
+        {
+            b->next = head;
+        } while (!released.compare_exchange_weak(head, b, std::memory_order_release, std::memory_order_relaxed));
+    }
+};
+
+inline void SharedPayload::reset(void)
+{
+    if (block && block->refs.fetch_sub(1, std::memory_order_acq_rel) == 1)
+    {
+        if (block->owner)
+        {
+            block->owner->recycle(block);
+        }
+        else
+        {
+            block->~Block();
+            ::operator delete(block, std::align_val_t(alignof(Block)));
+        }
+    }
+    block = nullptr;
+}
+
+// Telemetry record whose payload is shared rather than owned, for fan-out
+struct SharedTelemetry {
+    uint64_t timestamp_ns;
+    uint32_t seq;
+    TopicId topic_id;
+    SharedPayload payload;
+};
+
+#endif
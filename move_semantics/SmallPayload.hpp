@@ -0,0 +1,236 @@
+#ifndef SMALL_PAYLOAD_HPP
+#define SMALL_PAYLOAD_HPP
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <new>
+#include <utility>
+#include <vector>
+
+// Byte buffer with InlineBytes of in-object storage. Payloads up to InlineBytes (power
+// readings, gps fixes) live inside the record and never touch the heap; larger blobs fall
+// back to a std::vector<std::byte>, so moving a big payload is still a pointer steal.
+// Like std::vector, capacity never shrinks: once a payload is on the heap it stays there.
+// InlineBytes == 0 makes it behave like a plain vector.
+template <size_t InlineBytes>
+class SmallPayload
+{
+public:
+    using value_type = std::byte;
+    using iterator = std::byte*;
+    using const_iterator = const std::byte*;
+
+    SmallPayload() noexcept {}
+
+    // Adopts an existing heap buffer, e.g. a recycled one from PayloadPool. A buffer
+    // without capacity is not worth adopting, the payload then starts out inline.
+    SmallPayload(std::vector<std::byte>&& buf) noexcept
+    {
+        if (buf.capacity() > 0)
+        {
+            new (&heap) std::vector<std::byte>(std::move(buf));
+            onHeap = true;
+        }
+    }
+
+    SmallPayload(const SmallPayload& other)
+    {
+        assign(other.begin(), other.end());
+    }
+
+    SmallPayload(SmallPayload&& other) noexcept
+    {
+        stealFrom(other);
+    }
+
+    SmallPayload& operator=(const SmallPayload& other)
+    {
+        if (this != &other)
+        {
+            assign(other.begin(), other.end());
+        }
+        return *this;
+    }
+
+    SmallPayload& operator=(SmallPayload&& other) noexcept
+    {
+        if (this != &other)
+        {
+            destroy();
+            stealFrom(other);
+        }
+        return *this;
+    }
+
+    ~SmallPayload() { destroy(); }
+
+    std::byte* data(void) { return onHeap ? heap.data() : local.data(); }
+    const std::byte* data(void) const { return onHeap ? heap.data() : local.data(); }
+    size_t size(void) const { return onHeap ? heap.size() : len; }
+    bool empty(void) const { return size() == 0; }
+    size_t capacity(void) const { return onHeap ? heap.capacity() : InlineBytes; }
+    bool isInline(void) const { return !onHeap; }
+
+    iterator begin(void) { return data(); }
+    iterator end(void) { return data() + size(); }
+    const_iterator begin(void) const { return data(); }
+    const_iterator end(void) const { return data() + size(); }
+
+    std::byte& operator[](size_t i) { return data()[i]; }
+    const std::byte& operator[](size_t i) const { return data()[i]; }
+
+    void reserve(size_t n)
+    {
+        if (onHeap)
+        {
+            heap.reserve(n);
+        }
+        else if (n > InlineBytes)
+        {
+            moveToHeap(n);
+        }
+    }
+
+    void resize(size_t n, std::byte value = std::byte{0})
+    {
+        if (onHeap)
+        {
+            heap.resize(n, value);
+            return;
+        }
+        if (n > InlineBytes)
+        {
+            moveToHeap(n);
+            heap.resize(n, value);
+            return;
+        }
+        if (n > len)
+        {
+            std::fill(local.begin() + len, local.begin() + n, value);
+        }
+        len = static_cast<uint32_t>(n);
+    }
+
+    template <typename It>
+    void assign(It first, It last)
+    {
+        size_t n = static_cast<size_t>(std::distance(first, last));
+        if (onHeap)
+        {
+            heap.assign(first, last);
+        }
+        else if (n > InlineBytes)
+        {
+            moveToHeap(n);
+            heap.assign(first, last);
+        }
+        else if constexpr (InlineBytes > 0)
+        {
+            std::copy(first, last, local.begin());
+            len = static_cast<uint32_t>(n);
+        }
+    }
+
+    void push_back(std::byte b)
+    {
+        if (!onHeap && len < InlineBytes)
+        {
+            local[len++] = b;
+            return;
+        }
+        if (!onHeap)
+        {
+            moveToHeap(std::max<size_t>(InlineBytes * 2, 16));
+        }
+        heap.push_back(b);
+    }
+
+    void clear(void)
+    {
+        if (onHeap)
+        {
+            heap.clear();
+        }
+        else
+        {
+            len = 0;
+        }
+    }
+
+    // Hands the heap buffer out (empty if the payload is inline) and leaves this empty
+    // and inline, so a consumer can give large buffers back to a pool
+    std::vector<std::byte> take_heap(void)
+    {
+        std::vector<std::byte> buf;
+        if (onHeap)
+        {
+            buf = std::move(heap);
+            destroy();
+        }
+        len = 0;
+        return buf;
+    }
+
+private:
+    union
+    {
+        std::vector<std::byte> heap;
+        std::array<std::byte, InlineBytes> local;
+    };
+    uint32_t len = 0;    // inline size, unused on the heap
+    bool onHeap = false;
+
+    void destroy(void)
+    {
+        if (onHeap)
+        {
+            heap.~vector();
+            onHeap = false;
+        }
+    }
+
+    void stealFrom(SmallPayload& other) noexcept
+    {
+        if (other.onHeap)
+        {
+            new (&heap) std::vector<std::byte>(std::move(other.heap));
+            onHeap = true;
+            // The moved-from vector has no capacity left, let other start inline again
+            other.destroy();
+            other.len = 0;
+        }
+        else
+        {
+            if constexpr (InlineBytes > 0 && InlineBytes <= 256)
+            {
+                // A fixed-size copy compiles to a few vector moves, cheaper than a
+                // variable-length memcpy call for buffers this small
+                std::memcpy(local.data(), other.local.data(), InlineBytes);
+            }
+            else if (other.len > 0)
+            {
+                std::memcpy(local.data(), other.local.data(), other.len);
+            }
+            len = other.len;
+            onHeap = false;
+        }
+    }
+
+    void moveToHeap(size_t cap)
+    {
+        std::vector<std::byte> buf;
+        buf.reserve(cap);
+        if constexpr (InlineBytes > 0)
+        {
+            buf.assign(local.begin(), local.begin() + len);
+        }
+        new (&heap) std::vector<std::byte>(std::move(buf));
+        onHeap = true;
+    }
+};
+
+#endif
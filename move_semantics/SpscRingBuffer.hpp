@@ -0,0 +1,312 @@
+#ifndef SPSC_RING_BUFFER_HPP
+#define SPSC_RING_BUFFER_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <optional>
+#include <span>
+#include <stop_token>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// Bounded lock-free ring buffer for exactly one producer thread and one consumer thread.
+// Exposes the same push_data/pop_data API as TelemetryQueue so the two can be swapped at
+// compile time. Blocking calls spin briefly and then yield instead of parking on a
+// condition variable, so there is no mutex or notify on the hot path.
+
+constexpr size_t CACHE_LINE_SIZE = 64;
+
+// Helpers shared by the lock-free rings (SpscRingBuffer, BroadcastRing)
+namespace ring
+{
+// Busy-wait for a short while since the other side is usually a few ns away,
+// then give the core up so a single-core host still makes progress
+inline void backoff(unsigned spins)
+{
+    if (spins >= 64)
+    {
+        std::this_thread::yield();
+    }
+}
+
+inline size_t roundUpPow2(size_t len)
+{
+    size_t pow2 = 1;
+    while (pow2 < len)
+    {
+        pow2 <<= 1;
+    }
+    return pow2;
+}
+}
+
+template <typename T>
+class SpscRingBuffer
+{
+public:
+    // Capacity is rounded up to a power of two so wrapping is a mask instead of a modulo
+    explicit SpscRingBuffer(size_t len) : mask(ring::roundUpPow2(len) - 1), slots(new Slot[mask + 1])
+    {
+        assert(len > 0);
+    }
+
+    ~SpscRingBuffer()
+    {
+        while (try_pop())
+        {
+        }
+    }
+
+    SpscRingBuffer(const SpscRingBuffer&) = delete;
+    SpscRingBuffer& operator=(const SpscRingBuffer&) = delete;
+
+    // Producer side only
+    bool try_push(T&& data)
+    {
+        const size_t tail = producer.tail.load(std::memory_order_relaxed);
+        if (tail - producer.cachedHead > mask)
+        {
+            // Looks full from our stale view, refresh the consumer's position once
+            producer.cachedHead = consumer.head.load(std::memory_order_acquire);
+            if (tail - producer.cachedHead > mask)
+            {
+                return false;
+            }
+        }
+        new (slots[tail & mask].raw) T(std::move(data));
+        producer.tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    void push_data(T&& data)
+    {
+        for (unsigned spins = 0; !try_push(std::move(data)); ++spins)
+        {
+            ring::backoff(spins);
+        }
+    }
+
+    // Returns false, leaving data untouched, if st is stopped while the ring is full
+    bool push_data(T&& data, std::stop_token st)
+    {
+        for (unsigned spins = 0; !try_push(std::move(data)); ++spins)
+        {
+            if (st.stop_requested())
+            {
+                return false;
+            }
+            ring::backoff(spins);
+        }
+        return true;
+    }
+
+    // Will show with metrics that the copy version is less performant
+    void push_data_copy(T data)
+    {
+        push_data(std::move(data));
+    }
+
+    // Moves as many records from the front of batch as fit and publishes the new tail once
+    // for all of them. Returns how many were moved.
+    size_t try_push_batch(std::span<T> batch)
+    {
+        const size_t tail = producer.tail.load(std::memory_order_relaxed);
+        if (tail - producer.cachedHead + batch.size() > mask + 1)
+        {
+            producer.cachedHead = consumer.head.load(std::memory_order_acquire);
+        }
+        const size_t n = std::min(batch.size(), mask + 1 - (tail - producer.cachedHead));
+        size_t i = 0;
+        try
+        {
+            for (; i < n; ++i)
+            {
+                new (slots[(tail + i) & mask].raw) T(std::move(batch[i]));
+            }
+        }
+        catch (...)
+        {
+            // The slots already written hold moved-out records, hand them over
+            producer.tail.store(tail + i, std::memory_order_release);
+            throw;
+        }
+        if (n > 0)
+        {
+            producer.tail.store(tail + n, std::memory_order_release);
+        }
+        return n;
+    }
+
+    // Fills whatever room there is and publishes it in one go, then waits for more room
+    void push_batch(std::vector<T>&& batch)
+    {
+        size_t pushed = 0;
+        unsigned spins = 0;
+        while (pushed < batch.size())
+        {
+            if (size_t n = try_push_batch(std::span<T>(batch).subspan(pushed)))
+            {
+                pushed += n;
+                spins = 0;
+            }
+            else
+            {
+                ring::backoff(spins++);
+            }
+        }
+        batch.clear();
+    }
+
+    // Consumer side only
+    std::optional<T> try_pop(void)
+    {
+        const size_t head = consumer.head.load(std::memory_order_relaxed);
+        if (head == consumer.cachedTail)
+        {
+            consumer.cachedTail = producer.tail.load(std::memory_order_acquire);
+            if (head == consumer.cachedTail)
+            {
+                return std::nullopt;
+            }
+        }
+        T* slot = slotAt(head);
+        std::optional<T> data(std::move(*slot));
+        slot->~T();
+        consumer.head.store(head + 1, std::memory_order_release);
+        return data;
+    }
+
+    T pop_data(void)
+    {
+        for (unsigned spins = 0;; ++spins)
+        {
+            if (auto data = try_pop())
+            {
+                return std::move(*data);
+            }
+            ring::backoff(spins);
+        }
+    }
+
+    // Empty only if st was stopped while the ring was empty
+    std::optional<T> pop_data(std::stop_token st)
+    {
+        for (unsigned spins = 0;; ++spins)
+        {
+            if (auto data = try_pop())
+            {
+                return data;
+            }
+            if (st.stop_requested())
+            {
+                return std::nullopt;
+            }
+            ring::backoff(spins);
+        }
+    }
+
+    // Appends up to max_n records to out and publishes the new head once for the batch
+    size_t try_pop_batch(size_t max_n, std::vector<T>& out)
+    {
+        const size_t head = consumer.head.load(std::memory_order_relaxed);
+        if (consumer.cachedTail - head < max_n)
+        {
+            consumer.cachedTail = producer.tail.load(std::memory_order_acquire);
+        }
+        const size_t n = std::min(max_n, consumer.cachedTail - head);
+        for (size_t i = 0; i < n; ++i)
+        {
+            T* slot = slotAt(head + i);
+            out.push_back(std::move(*slot));
+            slot->~T();
+        }
+        if (n > 0)
+        {
+            consumer.head.store(head + n, std::memory_order_release);
+        }
+        return n;
+    }
+
+    // Returns 0 only if st was stopped while the ring was empty
+    size_t pop_batch(size_t max_n, std::vector<T>& out, std::stop_token st = {})
+    {
+        for (unsigned spins = 0;; ++spins)
+        {
+            if (size_t n = try_pop_batch(max_n, out))
+            {
+                return n;
+            }
+            if (st.stop_requested())
+            {
+                return 0;
+            }
+            ring::backoff(spins);
+        }
+    }
+
+    template <typename Rep, typename Period>
+    size_t drain_for(const std::chrono::duration<Rep, Period>& timeout, std::vector<T>& out,
+                     size_t max_n = SIZE_MAX, std::stop_token st = {})
+    {
+        const auto deadline = std::chrono::steady_clock::now() + timeout;
+        for (unsigned spins = 0;; ++spins)
+        {
+            if (size_t n = try_pop_batch(max_n, out))
+            {
+                return n;
+            }
+            if (st.stop_requested() || std::chrono::steady_clock::now() >= deadline)
+            {
+                return 0;
+            }
+            ring::backoff(spins);
+        }
+    }
+
+    // Approximate when called concurrently with push/pop
+    size_t getSize(void) const
+    {
+        return producer.tail.load(std::memory_order_acquire) - consumer.head.load(std::memory_order_acquire);
+    }
+
+    size_t capacity(void) const { return mask + 1; }
+
+private:
+    struct alignas(T) Slot
+    {
+        std::byte raw[sizeof(T)];
+    };
+
+    // Each side's index and its cached copy of the other side's index share a cache line,
+    // and the two sides never share one, so the only cross-core traffic is the refresh.
+    struct alignas(CACHE_LINE_SIZE) ProducerIndex
+    {
+        std::atomic<size_t> tail{0};
+        size_t cachedHead = 0;
+    };
+
+    struct alignas(CACHE_LINE_SIZE) ConsumerIndex
+    {
+        std::atomic<size_t> head{0};
+        size_t cachedTail = 0;
+    };
+
+    ProducerIndex producer;
+    ConsumerIndex consumer;
+    const size_t mask;
+    std::unique_ptr<Slot[]> slots;
+
+    T* slotAt(size_t index)
+    {
+        return std::launder(reinterpret_cast<T*>(slots[index & mask].raw));
+    }
+};
+
+#endif
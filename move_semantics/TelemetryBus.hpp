@@ -0,0 +1,100 @@
+#ifndef TELEMETRY_BUS_HPP
+#define TELEMETRY_BUS_HPP
+
+#include <array>
+#include <stop_token>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <vector>
+#include "TelemetryQueue.hpp"
+#include "TopicRegistry.hpp"
+
+// Topic-partitioned telemetry bus. Each consumer thread owns one TelemetryQueue shard and
+// every topic maps to exactly one shard (topic_id % consumers), so topics drain in
+// parallel while each topic's records stay in seq order. Any number of producers may
+// publish concurrently; the bus assigns the per-topic seq under the shard's lock.
+class TelemetryBus
+{
+public:
+    // Called on the owning consumer thread with a batch of records from one shard
+    using BatchHandler = std::function<void(size_t shard, std::vector<Telemetry> &batch)>;
+
+    TelemetryBus(size_t consumers, size_t shardCapacity, BatchHandler batchHandler, size_t maxBatch = 32)
+        : handler(std::move(batchHandler)), batchSize(maxBatch)
+    {
+        assert(consumers > 0);
+        for (size_t i = 0; i < consumers; ++i)
+        {
+            shards.push_back(std::make_unique<Shard>(shardCapacity));
+        }
+        for (size_t i = 0; i < consumers; ++i)
+        {
+            shards[i]->worker = std::jthread([this, i](std::stop_token st) { consume(i, st); });
+        }
+    }
+
+    ~TelemetryBus()
+    {
+        stop();
+    }
+
+    TelemetryBus(const TelemetryBus&) = delete;
+    TelemetryBus& operator=(const TelemetryBus&) = delete;
+
+    // Thread-safe. Overwrites data.seq with the topic's next sequence number.
+    void publish(Telemetry &&data)
+    {
+        Shard &shard = *shards[shardOf(data.topic_id)];
+        shard.q.push_data(std::move(data), [&shard](Telemetry &d) { d.seq = ++shard.topicSeq[d.topic_id]; });
+    }
+
+    size_t shardOf(TopicId id) const { return id % shards.size(); }
+    size_t consumers(void) const { return shards.size(); }
+
+    // Wakes idle consumers right away, lets them drain what is already queued, then joins
+    // them. Nothing may be published after stop().
+    void stop(void)
+    {
+        for (auto &shard : shards)
+        {
+            shard->worker.request_stop();
+        }
+        for (auto &shard : shards)
+        {
+            if (shard->worker.joinable())
+            {
+                shard->worker.join();
+            }
+        }
+    }
+
+private:
+    struct Shard
+    {
+        explicit Shard(size_t capacity) : q(capacity) {}
+        TelemetryQueue q;
+        // Only touched inside q's lock via the push stamp
+        std::array<uint32_t, TopicRegistry::MAX_TOPICS> topicSeq{};
+        std::jthread worker;
+    };
+
+    std::vector<std::unique_ptr<Shard>> shards;
+    BatchHandler handler;
+    size_t batchSize;
+
+    void consume(size_t index, std::stop_token st)
+    {
+        TelemetryQueue &q = shards[index]->q;
+        std::vector<Telemetry> batch;
+        batch.reserve(batchSize);
+        // pop_batch only comes back empty once stopped and drained
+        while (q.pop_batch(batchSize, batch, st) > 0)
+        {
+            handler(index, batch);
+            batch.clear();
+        }
+    }
+};
+
+#endif
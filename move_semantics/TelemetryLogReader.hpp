@@ -0,0 +1,343 @@
+#ifndef TELEMETRY_LOG_READER_HPP
+#define TELEMETRY_LOG_READER_HPP
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <iterator>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "TelemetryLogWriter.hpp"
+
+// Read side of the TelemetryLogWriter format. Segments are mmapped and records are handed
+// out as views pointing into the mapping, so iterating or seeking copies no payload bytes.
+// Seeks binary search a sparse index while seq (or timestamp_ns) increases through the log,
+// as one run of one writer produces them; once it goes backwards, e.g. in segments left by
+// an earlier run, they scan from the start instead. Segments too short to hold the magic,
+// or without it, such as one left empty by a crash, are skipped.
+
+struct TelemetryView {
+    uint64_t timestamp_ns;
+    uint32_t seq;
+    std::string_view topic;
+    std::span<const std::byte> payload;
+
+    // Copies out of the mapping, only needed when the record has to outlive the reader.
+    // The topic name stored on disk is interned back to an id.
+    Telemetry toTelemetry(TopicRegistry &registry = TopicRegistry::instance()) const
+    {
+        Telemetry data;
+        data.timestamp_ns = timestamp_ns;
+        data.seq = seq;
+        data.topic_id = registry.intern(topic);
+        data.payload.assign(payload.begin(), payload.end());
+        return data;
+    }
+};
+
+class MappedSegment
+{
+public:
+    explicit MappedSegment(const std::filesystem::path &path)
+    {
+        int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0)
+        {
+            throw std::runtime_error("MappedSegment open " + path.string() + ": " + std::strerror(errno));
+        }
+        struct stat sb;
+        if (::fstat(fd, &sb) != 0)
+        {
+            ::close(fd);
+            throw std::runtime_error("MappedSegment fstat " + path.string() + ": " + std::strerror(errno));
+        }
+        len = static_cast<size_t>(sb.st_size);
+        if (len > 0)
+        {
+            void *p = ::mmap(nullptr, len, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (p == MAP_FAILED)
+            {
+                ::close(fd);
+                throw std::runtime_error("MappedSegment mmap " + path.string() + ": " + std::strerror(errno));
+            }
+            base = static_cast<const std::byte*>(p);
+        }
+        // The mapping stays valid after the descriptor is closed
+        ::close(fd);
+    }
+
+    ~MappedSegment() { unmap(); }
+
+    MappedSegment(MappedSegment &&other) noexcept : base(other.base), len(other.len)
+    {
+        other.base = nullptr;
+        other.len = 0;
+    }
+    MappedSegment& operator=(MappedSegment&&) = delete;
+    MappedSegment(const MappedSegment&) = delete;
+    MappedSegment& operator=(const MappedSegment&) = delete;
+
+    const std::byte* data(void) const { return base; }
+    size_t size(void) const { return len; }
+
+    bool hasMagic(void) const
+    {
+        return len >= sizeof(SEGMENT_MAGIC) && std::memcmp(base, SEGMENT_MAGIC, sizeof(SEGMENT_MAGIC)) == 0;
+    }
+
+private:
+    const std::byte *base = nullptr;
+    size_t len = 0;
+
+    void unmap(void)
+    {
+        if (base)
+        {
+            ::munmap(const_cast<std::byte*>(base), len);
+            base = nullptr;
+        }
+    }
+};
+
+class TelemetryLogReader
+{
+    struct Position {
+        uint32_t segment;
+        uint64_t offset;
+    };
+
+public:
+    // Maps every segment in dir and builds a sparse index holding one entry per
+    // indexStride records, so a seek is a binary search plus at most indexStride steps.
+    explicit TelemetryLogReader(const std::filesystem::path &dir, size_t indexStride = 64) : stride(indexStride)
+    {
+        std::vector<std::filesystem::path> paths;
+        for (uint32_t i = 0; std::filesystem::exists(segmentPath(dir, i)); ++i)
+        {
+            paths.push_back(segmentPath(dir, i));
+        }
+        for (const auto &path : paths)
+        {
+            MappedSegment seg(path);
+            if (seg.hasMagic())
+            {
+                segments.push_back(std::move(seg));
+            }
+            else
+            {
+                ++badSegments;
+            }
+        }
+        buildIndex();
+    }
+
+    class iterator
+    {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = TelemetryView;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const TelemetryView*;
+        using reference = TelemetryView;
+
+        iterator() = default;
+        TelemetryView operator*() const { return reader->viewAt(pos); }
+        iterator& operator++()
+        {
+            pos = reader->next(pos);
+            return *this;
+        }
+        iterator operator++(int)
+        {
+            iterator prev = *this;
+            ++*this;
+            return prev;
+        }
+        bool operator==(const iterator &other) const
+        {
+            return pos.segment == other.pos.segment && pos.offset == other.pos.offset;
+        }
+
+    private:
+        friend class TelemetryLogReader;
+        iterator(const TelemetryLogReader *r, Position p) : reader(r), pos(p) {}
+        const TelemetryLogReader *reader = nullptr;
+        Position pos{0, 0};
+    };
+
+    iterator begin(void) const { return iterator(this, normalize({0, sizeof(SEGMENT_MAGIC)})); }
+    iterator end(void) const { return iterator(this, endPosition()); }
+    size_t size(void) const { return records; }
+    size_t skippedSegments(void) const { return badSegments; }
+
+    // First record with seq >= target
+    iterator seekSeq(uint32_t target) const
+    {
+        auto it = index.begin();
+        if (seqSorted)
+        {
+            it = std::upper_bound(index.begin(), index.end(), target,
+                                  [](uint32_t v, const IndexEntry &e) { return v < e.seq; });
+        }
+        return scanFrom(it, [&](const TelemetryView &v) { return v.seq >= target; });
+    }
+
+    // First record with timestamp_ns >= target
+    iterator seekTime(uint64_t target) const
+    {
+        auto it = index.begin();
+        if (timeSorted)
+        {
+            it = std::upper_bound(index.begin(), index.end(), target,
+                                  [](uint64_t v, const IndexEntry &e) { return v < e.timestamp_ns; });
+        }
+        return scanFrom(it, [&](const TelemetryView &v) { return v.timestamp_ns >= target; });
+    }
+
+    // Pushes every record with from_ns <= timestamp_ns < to_ns into q. speed 1.0 keeps the
+    // original gaps between records, 10.0 replays ten times faster and 0 does not pace at
+    // all. Returns the number of records replayed.
+    template <typename Queue>
+    size_t replay(Queue &q, uint64_t from_ns, uint64_t to_ns, double speed = 1.0) const
+    {
+        size_t count = 0;
+        auto wallStart = std::chrono::steady_clock::now();
+        uint64_t logStart = 0;
+        for (auto it = seekTime(from_ns); it != end(); ++it)
+        {
+            TelemetryView view = *it;
+            if (view.timestamp_ns >= to_ns)
+            {
+                break;
+            }
+            if (count == 0)
+            {
+                logStart = view.timestamp_ns;
+            }
+            else if (speed > 0)
+            {
+                auto offset = std::chrono::nanoseconds(static_cast<int64_t>((view.timestamp_ns - logStart) / speed));
+                std::this_thread::sleep_until(wallStart + offset);
+            }
+            q.push_data(view.toTelemetry());
+            ++count;
+        }
+        return count;
+    }
+
+private:
+    struct IndexEntry {
+        uint64_t timestamp_ns;
+        uint32_t seq;
+        Position pos;
+    };
+
+    std::vector<MappedSegment> segments;
+    // End of the last complete record in each segment, a torn tail is ignored
+    std::vector<uint64_t> validEnd;
+    std::vector<IndexEntry> index;
+    size_t stride;
+    size_t records = 0;
+    size_t badSegments = 0;
+    // Whether the index can be binary searched on seq / timestamp_ns
+    bool seqSorted = true;
+    bool timeSorted = true;
+
+    static TelemetryRecordHeader headerAt(const std::byte *p)
+    {
+        TelemetryRecordHeader h;
+        std::memcpy(&h, p, sizeof(h));
+        return h;
+    }
+
+    TelemetryView viewAt(Position pos) const
+    {
+        const std::byte *p = segments[pos.segment].data() + pos.offset;
+        TelemetryRecordHeader h = headerAt(p);
+        const std::byte *topic = p + sizeof(h);
+        return TelemetryView{h.timestamp_ns, h.seq,
+                             std::string_view(reinterpret_cast<const char*>(topic), h.topic_len),
+                             std::span<const std::byte>(topic + h.topic_len, h.payload_len)};
+    }
+
+    Position endPosition(void) const
+    {
+        return {static_cast<uint32_t>(segments.size()), 0};
+    }
+
+    // Steps over exhausted segments so every position is either a record or end()
+    Position normalize(Position pos) const
+    {
+        while (pos.segment < segments.size() && pos.offset >= validEnd[pos.segment])
+        {
+            pos = {pos.segment + 1, sizeof(SEGMENT_MAGIC)};
+        }
+        return pos.segment < segments.size() ? pos : endPosition();
+    }
+
+    Position next(Position pos) const
+    {
+        TelemetryRecordHeader h = headerAt(segments[pos.segment].data() + pos.offset);
+        return normalize({pos.segment, pos.offset + sizeof(h.length) + h.length});
+    }
+
+    template <typename Pred>
+    iterator scanFrom(std::vector<IndexEntry>::const_iterator upper, Pred reached) const
+    {
+        // The entry before upper is the last indexed record not past the target
+        iterator it = upper == index.begin() ? begin() : iterator(this, std::prev(upper)->pos);
+        while (it != end() && !reached(*it))
+        {
+            ++it;
+        }
+        return it;
+    }
+
+    // Walks the header chain once; payload pages are never touched
+    void buildIndex(void)
+    {
+        uint32_t prevSeq = 0;
+        uint64_t prevTime = 0;
+        validEnd.resize(segments.size());
+        for (uint32_t s = 0; s < segments.size(); ++s)
+        {
+            const MappedSegment &seg = segments[s];
+            uint64_t offset = sizeof(SEGMENT_MAGIC);
+            while (offset + sizeof(TelemetryRecordHeader) <= seg.size())
+            {
+                TelemetryRecordHeader h = headerAt(seg.data() + offset);
+                uint64_t recordEnd = offset + sizeof(h.length) + h.length;
+                bool consistent = h.length == sizeof(h) - sizeof(h.length) + h.topic_len + h.payload_len;
+                if (!consistent || recordEnd > seg.size())
+                {
+                    break;
+                }
+                if (records % stride == 0)
+                {
+                    index.push_back({h.timestamp_ns, h.seq, {s, offset}});
+                }
+                if (records > 0)
+                {
+                    seqSorted = seqSorted && h.seq >= prevSeq;
+                    timeSorted = timeSorted && h.timestamp_ns >= prevTime;
+                }
+                prevSeq = h.seq;
+                prevTime = h.timestamp_ns;
+                ++records;
+                offset = recordEnd;
+            }
+            validEnd[s] = offset;
+        }
+    }
+};
+
+#endif
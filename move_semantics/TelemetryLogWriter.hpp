@@ -0,0 +1,360 @@
+#ifndef TELEMETRY_LOG_WRITER_HPP
+#define TELEMETRY_LOG_WRITER_HPP
+
+#include <algorithm>
+#include <chrono>
+#include <cerrno>
+#include <climits>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <condition_variable>
+#include <filesystem>
+#include <mutex>
+#include <stdexcept>
+#include <stop_token>
+#include <string>
+#include <thread>
+#include <vector>
+#include <fcntl.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#include "TelemetryQueue.hpp"
+
+// Append-only binary telemetry log split into size-bounded segment files.
+//
+// Segment layout: SEGMENT_MAGIC, then back to back records of
+//   TelemetryRecordHeader | topic name bytes | payload bytes
+// where header.length counts everything after the length field itself.
+// All integers are in host byte order.
+
+constexpr char SEGMENT_MAGIC[8] = {'T', 'L', 'M', 'L', 'O', 'G', '0', '1'};
+
+struct TelemetryRecordHeader {
+    uint32_t length;        // bytes following this field
+    uint32_t seq;
+    uint64_t timestamp_ns;
+    uint32_t payload_len;
+    uint16_t topic_len;
+    uint16_t reserved;
+};
+static_assert(sizeof(TelemetryRecordHeader) == 24, "on-disk header layout changed");
+
+struct LogWriterConfig {
+    std::filesystem::path directory = "telemetry_log";
+    uint64_t segment_bytes = 64ull << 20;
+    // fdatasync at most once per window; zero syncs after every append. A window left open
+    // when appends stop is synced by a flusher thread once it has passed.
+    std::chrono::microseconds group_commit_window{2000};
+    // Remove the segments a previous run left in directory instead of writing after them
+    bool fresh_log = false;
+};
+
+struct LogWriterStats {
+    uint64_t records = 0;
+    uint64_t bytes = 0;
+    uint64_t syncs = 0;
+    uint64_t segments = 0;
+};
+
+inline std::filesystem::path segmentPath(const std::filesystem::path &dir, uint32_t index)
+{
+    char name[32];
+    std::snprintf(name, sizeof(name), "telemetry-%08u.log", index);
+    return dir / name;
+}
+
+class TelemetryLogWriter
+{
+public:
+    // Records carry topic ids, registry resolves them back to the names stored on disk
+    explicit TelemetryLogWriter(LogWriterConfig config, const TopicRegistry &registry = TopicRegistry::instance())
+        : cfg(std::move(config)), topics(registry)
+    {
+        std::filesystem::create_directories(cfg.directory);
+        // Never append into a previous run's segments: remove them or start after the last one
+        while (std::filesystem::exists(segmentPath(cfg.directory, nextSegment)))
+        {
+            ++nextSegment;
+        }
+        if (cfg.fresh_log)
+        {
+            while (nextSegment > 0)
+            {
+                std::filesystem::remove(segmentPath(cfg.directory, --nextSegment));
+            }
+        }
+        openSegment();
+        lastSync = std::chrono::steady_clock::now();
+        if (cfg.group_commit_window.count() > 0)
+        {
+            flusher = std::jthread([this](std::stop_token stop) { flushIdle(stop); });
+        }
+    }
+
+    ~TelemetryLogWriter()
+    {
+        if (flusher.joinable())
+        {
+            flusher.request_stop();
+            flusher.join();
+        }
+        if (fd >= 0)
+        {
+            if (unsynced && ::fdatasync(fd) == 0)
+            {
+                ++st.syncs;
+            }
+            ::close(fd);
+        }
+    }
+
+    TelemetryLogWriter(const TelemetryLogWriter&) = delete;
+    TelemetryLogWriter& operator=(const TelemetryLogWriter&) = delete;
+
+    // Writes the batch with vectored writes straight from the records' topic and payload
+    // storage, rolling to a new segment whenever the next record would not fit.
+    // Throws before writing anything if a topic name or payload does not fit the header.
+    void append(const std::vector<Telemetry> &batch)
+    {
+        for (const Telemetry &data : batch)
+        {
+            checkFits(data);
+        }
+        std::lock_guard<std::mutex> lock(mtx);
+        const bool wasUnsynced = unsynced;
+        size_t begin = 0;
+        while (begin < batch.size())
+        {
+            size_t end = begin;
+            uint64_t bytes = 0;
+            while (end < batch.size())
+            {
+                uint64_t rec = recordSize(batch[end]);
+                // A record larger than a whole segment still gets written into an empty one
+                if (segmentBytes + bytes + rec > cfg.segment_bytes && segmentBytes + bytes > sizeof(SEGMENT_MAGIC))
+                {
+                    break;
+                }
+                bytes += rec;
+                ++end;
+            }
+            if (end == begin)
+            {
+                rollSegment();
+                continue;
+            }
+            writeRecords(batch, begin, end);
+            begin = end;
+        }
+        maybeSync();
+        if (unsynced && !wasUnsynced)
+        {
+            flushCv.notify_one();
+        }
+    }
+
+    void sync(void)
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        syncLocked();
+    }
+
+    // Syncs what is written but not yet synced, if anything
+    void flush(void)
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        if (unsynced)
+        {
+            syncLocked();
+        }
+    }
+
+    LogWriterStats stats(void) const
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        return st;
+    }
+
+private:
+    LogWriterConfig cfg;
+    const TopicRegistry &topics;
+    int fd = -1;
+    uint32_t nextSegment = 0;
+    uint64_t segmentBytes = 0;
+    bool unsynced = false;
+    std::chrono::steady_clock::time_point lastSync;
+    LogWriterStats st;
+    // Reused across appends so steady-state writes do not allocate
+    std::vector<TelemetryRecordHeader> headers;
+    std::vector<iovec> iovs;
+    // Serializes appends with the flusher, which only runs with a group-commit window
+    mutable std::mutex mtx;
+    std::condition_variable_any flushCv;
+    std::jthread flusher;
+
+    void checkFits(const Telemetry &data) const
+    {
+        if (topics.name(data.topic_id).size() > UINT16_MAX)
+        {
+            throw std::runtime_error("TelemetryLogWriter topic name longer than 65535 bytes");
+        }
+        if (recordSize(data) - sizeof(TelemetryRecordHeader::length) > UINT32_MAX)
+        {
+            throw std::runtime_error("TelemetryLogWriter record larger than 4 GiB");
+        }
+    }
+
+    void syncLocked(void)
+    {
+        if (::fdatasync(fd) != 0)
+        {
+            throwErrno("fdatasync");
+        }
+        ++st.syncs;
+        unsynced = false;
+        lastSync = std::chrono::steady_clock::now();
+    }
+
+    // Sleeps until an append leaves data unsynced, then syncs it once its window has passed
+    // unless an append got there first. A failed sync is left for the next append to report.
+    void flushIdle(std::stop_token stop)
+    {
+        std::unique_lock<std::mutex> lock(mtx);
+        while (flushCv.wait(lock, stop, [this]() { return unsynced; }))
+        {
+            // Appends may sync and open a new window meanwhile, so wait for the current one
+            auto due = lastSync + cfg.group_commit_window;
+            while (unsynced && !stop.stop_requested() && std::chrono::steady_clock::now() < due)
+            {
+                flushCv.wait_until(lock, stop, due, []() { return false; });
+                due = lastSync + cfg.group_commit_window;
+            }
+            if (unsynced && !stop.stop_requested())
+            {
+                if (::fdatasync(fd) == 0)
+                {
+                    ++st.syncs;
+                    unsynced = false;
+                }
+                lastSync = std::chrono::steady_clock::now();
+            }
+        }
+    }
+
+    uint64_t recordSize(const Telemetry &data) const
+    {
+        return sizeof(TelemetryRecordHeader) + topics.name(data.topic_id).size() + data.payload.size();
+    }
+
+    [[noreturn]] static void throwErrno(const char *what)
+    {
+        throw std::runtime_error(std::string("TelemetryLogWriter ") + what + ": " + std::strerror(errno));
+    }
+
+    void openSegment(void)
+    {
+        std::filesystem::path path = segmentPath(cfg.directory, nextSegment++);
+        fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_EXCL | O_APPEND | O_CLOEXEC, 0644);
+        if (fd < 0)
+        {
+            throwErrno("open");
+        }
+        iovec magic{const_cast<char*>(SEGMENT_MAGIC), sizeof(SEGMENT_MAGIC)};
+        writeAll(&magic, 1);
+        segmentBytes = sizeof(SEGMENT_MAGIC);
+        ++st.segments;
+    }
+
+    void rollSegment(void)
+    {
+        if (unsynced)
+        {
+            syncLocked();
+        }
+        ::close(fd);
+        fd = -1;
+        openSegment();
+    }
+
+    void writeRecords(const std::vector<Telemetry> &batch, size_t begin, size_t end)
+    {
+        // Headers must all exist before taking their addresses for the iovecs
+        headers.clear();
+        uint64_t bytes = 0;
+        for (size_t i = begin; i < end; ++i)
+        {
+            const Telemetry &data = batch[i];
+            TelemetryRecordHeader h{};
+            // append's checkFits has ruled out truncation in these casts
+            h.length = static_cast<uint32_t>(recordSize(data) - sizeof(h.length));
+            h.seq = data.seq;
+            h.timestamp_ns = data.timestamp_ns;
+            h.payload_len = static_cast<uint32_t>(data.payload.size());
+            h.topic_len = static_cast<uint16_t>(topics.name(data.topic_id).size());
+            headers.push_back(h);
+            bytes += recordSize(data);
+        }
+        iovs.clear();
+        for (size_t i = begin; i < end; ++i)
+        {
+            const Telemetry &data = batch[i];
+            const std::string &topic = topics.name(data.topic_id);
+            iovs.push_back({&headers[i - begin], sizeof(TelemetryRecordHeader)});
+            if (!topic.empty())
+            {
+                iovs.push_back({const_cast<char*>(topic.data()), topic.size()});
+            }
+            if (!data.payload.empty())
+            {
+                iovs.push_back({const_cast<std::byte*>(data.payload.data()), data.payload.size()});
+            }
+        }
+        writeAll(iovs.data(), iovs.size());
+        segmentBytes += bytes;
+        st.bytes += bytes;
+        st.records += end - begin;
+        unsynced = true;
+    }
+
+    // writev may write less than asked and caps the iovec count, so keep going until done
+    void writeAll(iovec *iov, size_t count)
+    {
+        while (count > 0)
+        {
+            int chunk = static_cast<int>(std::min<size_t>(count, IOV_MAX));
+            ssize_t n = ::writev(fd, iov, chunk);
+            if (n < 0)
+            {
+                if (errno == EINTR)
+                {
+                    continue;
+                }
+                throwErrno("writev");
+            }
+            size_t written = static_cast<size_t>(n);
+            while (count > 0 && written >= iov->iov_len)
+            {
+                written -= iov->iov_len;
+                ++iov;
+                --count;
+            }
+            if (written > 0)
+            {
+                iov->iov_base = static_cast<char*>(iov->iov_base) + written;
+                iov->iov_len -= written;
+            }
+        }
+    }
+
+    // Group commit: one fdatasync covers every append since the window opened
+    void maybeSync(void)
+    {
+        if (unsynced && std::chrono::steady_clock::now() - lastSync >= cfg.group_commit_window)
+        {
+            syncLocked();
+        }
+    }
+};
+
+#endif
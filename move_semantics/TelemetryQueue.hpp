@@ -2,72 +2,467 @@
 #define TELEMETRY_QUEUE_HPP
 
 #include <iostream>
-#include <deque>
 #include <mutex>
-#include <condition_variable>
 #include <vector>
 #include <cassert>
 #include <optional>
+#include <chrono>
+#include <algorithm>
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <atomic>
+#include <concepts>
+#include <stop_token>
+#include <type_traits>
+#include "TopicRegistry.hpp"
+#include "OverflowPolicy.hpp"
+#include "QueueStats.hpp"
+#include "SmallPayload.hpp"
+#include "WaitStrategy.hpp"
+#include "PayloadPool.hpp"
+
+// Payloads up to this many bytes are stored inside the Telemetry record itself.
+// Build with -DTELEMETRY_INLINE_PAYLOAD_BYTES=0 to always use the heap.
+#ifndef TELEMETRY_INLINE_PAYLOAD_BYTES
+#define TELEMETRY_INLINE_PAYLOAD_BYTES 128
+#endif
+
+using TelemetryPayload = SmallPayload<TELEMETRY_INLINE_PAYLOAD_BYTES>;
 
 struct Telemetry {
     // hot metadata (small)
     uint64_t timestamp_ns;
     uint32_t seq;
-    std::string topic;                // e.g., "imu", "gps", "power"
+    TopicId topic_id;                 // interned "imu", "gps", "power", see TopicRegistry
 
     // cold, potentially huge payload
-    std::vector<std::byte> payload;   // compressed protobuf / flatbuffer blob
+    TelemetryPayload payload;         // compressed protobuf / flatbuffer blob, inline when small
 
     // Moving is cheap (pointer/size steals); copying is expensive (deep copy).
 };
 
-class TelemetryQueue
+// Wait is one of the strategies in WaitStrategy.hpp and decides how blocked producers and
+// consumers wait: spinning, yielding, or parked on a futex (the default). Every blocking
+// call can also be given a std::stop_token; a stop request wakes it immediately.
+template <typename Wait = SpinThenPark>
+class BasicTelemetryQueue
 {
 public:
-    explicit TelemetryQueue(size_t len) : max_len(len) { assert(max_len > 0); }
+    explicit BasicTelemetryQueue(size_t len, OverflowPolicy overflowPolicy = OverflowPolicy::block())
+        : q(len), max_len(len), policy(overflowPolicy), stats(len)
+    {
+        assert(max_len > 0);
+    }
+
     // Will show with metrics that the copy version is less performant
-    void push_data_copy(Telemetry data)
+    bool push_data_copy(Telemetry data)
+    {
+        return push_data(std::move(data));
+    }
+
+    // Returns false if the overflow policy dropped data instead of queueing it, or if st
+    // was stopped while waiting for room
+    bool push_data(Telemetry&& data, std::stop_token st = {})
+    {
+        return push_data(std::move(data), [](Telemetry&) {}, st);
+    }
+
+    // Runs stamp(data) under the queue lock just before enqueueing, so anything it assigns
+    // (e.g. a per-topic seq) is ordered exactly like the queue even with many producers.
+    // A record that is not queued is never stamped.
+    template <typename Stamp>
+        requires std::invocable<Stamp&, Telemetry&>
+    bool push_data(Telemetry&& data, Stamp&& stamp, std::stop_token st = {})
     {
+        std::optional<Deadline> deadline;
         std::unique_lock<std::mutex> lock(m);
-        not_full_cv.wait(lock, [&]{ return q.size() < max_len;});
-        q.push_back(std::move(data));
+        if (!make_room(lock, deadline, st))
+        {
+            return false;
+        }
+        stamp(data);
+        push_locked(std::move(data));
         lock.unlock();
-        not_empty_cv.notify_one();
+        not_empty_sig.notify_one();
+        return true;
     }
 
-    void push_data(Telemetry&& data)
+    // Never waits and ignores the overflow policy: queues data if there is room, otherwise
+    // returns false and leaves data untouched
+    bool try_push(Telemetry&& data)
     {
         std::unique_lock<std::mutex> lock(m);
-        not_full_cv.wait(lock, [&]{ return q.size() < max_len;});
-        q.push_back(std::move(data));
+        if (q.size() >= max_len)
+        {
+            bump(overflow.rejected);
+            return false;
+        }
+        push_locked(std::move(data));
+        lock.unlock();
+        not_empty_sig.notify_one();
+        return true;
+    }
+
+    // Waits for room until deadline whatever the overflow policy is. On timeout or stop
+    // returns false and leaves data untouched, so the caller decides what to drop.
+    template <typename Clock, typename Duration>
+    bool push_until(Telemetry&& data, const std::chrono::time_point<Clock, Duration>& deadline, std::stop_token st = {})
+    {
+        std::unique_lock<std::mutex> lock(m);
+        if (!wait_not_full(lock, st, toDeadline(deadline)))
+        {
+            if (!st.stop_requested())
+            {
+                bump(overflow.timed_out);
+            }
+            return false;
+        }
+        push_locked(std::move(data));
+        lock.unlock();
+        not_empty_sig.notify_one();
+        return true;
+    }
+
+    // Moves the whole batch in under one lock acquisition and wakes consumers once. Records
+    // that find the queue full go through the overflow policy; a BlockWithTimeout batch
+    // waits at most one timeout in total. Returns the number of records queued. Handled
+    // records, queued or dropped by the policy, are erased from batch; if st stops the
+    // batch partway, the records it never reached stay in batch, in order.
+    size_t push_batch(std::vector<Telemetry>&& batch, std::stop_token st = {})
+    {
+        size_t pushed = 0;
+        size_t handled = 0;
+        std::optional<Deadline> deadline;
+        std::unique_lock<std::mutex> lock(m);
+        for (; handled < batch.size(); ++handled)
+        {
+            Telemetry& data = batch[handled];
+            if (q.size() >= max_len && blocking())
+            {
+                // Let consumers make room for the rest of the batch
+                lock.unlock();
+                not_empty_sig.notify_all();
+                lock.lock();
+            }
+            if (make_room(lock, deadline, st))
+            {
+                push_locked(std::move(data));
+                ++pushed;
+            }
+            else if (st.stop_requested())
+            {
+                break;
+            }
+        }
         lock.unlock();
-        not_empty_cv.notify_one();
+        batch.erase(batch.begin(), batch.begin() + handled);
+        if (pushed > 1)
+        {
+            not_empty_sig.notify_all();
+        }
+        else if (pushed == 1)
+        {
+            not_empty_sig.notify_one();
+        }
+        return pushed;
     }
 
     Telemetry pop_data(void)
     {
         std::unique_lock<std::mutex> lock(m);
-        not_empty_cv.wait(lock, [&] { return !q.empty(); });
+        wait_not_empty(lock, {});
         // get oldest data
-        Telemetry data = std::move(q.front());
-        q.pop_front();
+        Telemetry data = pop_locked();
+        lock.unlock();
+        not_full_sig.notify_one();
+        return data;
+    }
+
+    // Empty only if st was stopped while the queue was empty
+    std::optional<Telemetry> pop_data(std::stop_token st)
+    {
+        std::unique_lock<std::mutex> lock(m);
+        if (!wait_not_empty(lock, st))
+        {
+            return std::nullopt;
+        }
+        std::optional<Telemetry> data(pop_locked());
         lock.unlock();
-        not_full_cv.notify_one();
+        not_full_sig.notify_one();
         return data;
     }
 
+    // Blocks until at least one record is available, then appends up to max_n records to
+    // out under one lock acquisition. Returns the number of records appended, 0 only if st
+    // was stopped while the queue was empty, so a consumer drains before it exits.
+    size_t pop_batch(size_t max_n, std::vector<Telemetry>& out, std::stop_token st = {})
+    {
+        std::unique_lock<std::mutex> lock(m);
+        if (!wait_not_empty(lock, st))
+        {
+            return 0;
+        }
+        return take_locked(max_n, out, lock);
+    }
+
+    // Like pop_batch, but gives up after timeout and returns 0 if nothing arrived
+    template <typename Rep, typename Period>
+    size_t drain_for(const std::chrono::duration<Rep, Period>& timeout, std::vector<Telemetry>& out,
+                     size_t max_n = SIZE_MAX, std::stop_token st = {})
+    {
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::duration_cast<std::chrono::steady_clock::duration>(timeout);
+        std::unique_lock<std::mutex> lock(m);
+        if (!wait_not_empty(lock, st, deadline))
+        {
+            return 0;
+        }
+        return take_locked(max_n, out, lock);
+    }
+
+    // Records evicted by DropOldest or Sample give their payload buffer back to pool instead
+    // of freeing it. The evicting push runs on the pushing thread, so with a pool set only
+    // the pool's producing thread may push.
+    void set_payload_pool(PayloadPool *pool)
+    {
+        std::unique_lock<std::mutex> lock(m);
+        evictPool = pool;
+    }
+
     size_t getSize(void)
     {
         std::unique_lock<std::mutex> lock(m);
         return q.size();
     }
 
+    // Lock-free, safe to poll from a monitoring thread. All zeros unless built with
+    // -DTELEMETRY_QUEUE_STATS.
+    QueueStatsSnapshot getStats(void) const
+    {
+        return stats.snapshot();
+    }
+
+    // Lock-free like getStats, but always available
+    OverflowCounts getOverflowCounts(void) const
+    {
+        OverflowCounts c;
+        c.timed_out = overflow.timed_out.load(std::memory_order_relaxed);
+        c.dropped_newest = overflow.dropped_newest.load(std::memory_order_relaxed);
+        c.dropped_oldest = overflow.dropped_oldest.load(std::memory_order_relaxed);
+        c.sampled_out = overflow.sampled_out.load(std::memory_order_relaxed);
+        c.rejected = overflow.rejected.load(std::memory_order_relaxed);
+        return c;
+    }
+
 private:
-    std::deque<Telemetry> q;
+    // Fixed ring of pre-constructed slots. Unlike std::deque it never allocates or frees
+    // blocks as records flow through, so steady-state push/pop does no heap work.
+    class SlotRing
+    {
+    public:
+        explicit SlotRing(size_t len) : slots(len) {}
+        size_t size(void) const { return count; }
+        bool empty(void) const { return count == 0; }
+        Telemetry& front(void) { return slots[head]; }
+        void push_back(Telemetry&& data)
+        {
+            slots[(head + count) % slots.size()] = std::move(data);
+            ++count;
+        }
+        void pop_front(void)
+        {
+            head = (head + 1) % slots.size();
+            --count;
+        }
+    private:
+        std::vector<Telemetry> slots;
+        size_t head = 0;
+        size_t count = 0;
+    };
+
+    using Deadline = WaitSignal::Deadline;
+
+    SlotRing q;
     std::mutex m;
-    std::condition_variable not_empty_cv;
-    std::condition_variable not_full_cv;
+    WaitSignal not_empty_sig;
+    WaitSignal not_full_sig;
     size_t max_len;
+    OverflowPolicy policy;
+    uint64_t overflowed = 0;   // records that found the queue full, drives Sample
+    PayloadPool *evictPool = nullptr;
+    [[no_unique_address]] QueueStats stats;
+
+    // Only written under the lock, atomic so getOverflowCounts can read them without it
+    struct
+    {
+        std::atomic<uint64_t> timed_out{0};
+        std::atomic<uint64_t> dropped_newest{0};
+        std::atomic<uint64_t> dropped_oldest{0};
+        std::atomic<uint64_t> sampled_out{0};
+        std::atomic<uint64_t> rejected{0};
+    } overflow;
+
+    static void bump(std::atomic<uint64_t> &counter)
+    {
+        counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+
+    template <typename Clock, typename Duration>
+    static Deadline toDeadline(const std::chrono::time_point<Clock, Duration>& t)
+    {
+        if constexpr (std::is_same_v<Clock, std::chrono::steady_clock>)
+        {
+            return std::chrono::time_point_cast<Deadline::duration>(t);
+        }
+        else
+        {
+            return std::chrono::steady_clock::now() +
+                   std::chrono::duration_cast<Deadline::duration>(t - Clock::now());
+        }
+    }
+
+    bool blocking(void) const
+    {
+        return policy.mode == Overflow::Block || policy.mode == Overflow::BlockWithTimeout;
+    }
+
+    // Makes room for one more record as the overflow policy says, returns false if the
+    // new record is to be dropped instead or st was stopped. The deadline is fixed the
+    // first time a BlockWithTimeout push has to wait and shared by the rest of a batch.
+    bool make_room(std::unique_lock<std::mutex>& lock, std::optional<Deadline>& deadline, const std::stop_token& st)
+    {
+        if (q.size() < max_len)
+        {
+            return true;
+        }
+        switch (policy.mode)
+        {
+        case Overflow::Block:
+            return wait_not_full(lock, st);
+        case Overflow::BlockWithTimeout:
+            if (!deadline)
+            {
+                deadline = std::chrono::steady_clock::now() + policy.timeout;
+            }
+            if (wait_not_full(lock, st, *deadline))
+            {
+                return true;
+            }
+            if (!st.stop_requested())
+            {
+                bump(overflow.timed_out);
+            }
+            return false;
+        case Overflow::DropNewest:
+            bump(overflow.dropped_newest);
+            return false;
+        case Overflow::DropOldest:
+            evict_oldest_locked();
+            return true;
+        case Overflow::Sample:
+            if (++overflowed % policy.keepEvery == 0)
+            {
+                evict_oldest_locked();
+                return true;
+            }
+            bump(overflow.sampled_out);
+            return false;
+        }
+        return false;
+    }
+
+    void evict_oldest_locked(void)
+    {
+        if (evictPool)
+        {
+            evictPool->reclaim(q.front().payload.take_heap());
+        }
+        q.pop_front();
+        bump(overflow.dropped_oldest);
+    }
+
+    // Releases the lock while waiting on signal until ready() holds, st is stopped or the
+    // deadline passes. Returns ready() with the lock held again.
+    template <typename Pred>
+    bool await(std::unique_lock<std::mutex>& lock, WaitSignal& signal, Pred ready, const std::stop_token& st,
+               Deadline deadline)
+    {
+        while (!ready())
+        {
+            if (st.stop_requested() || (deadline != WaitSignal::NO_DEADLINE && std::chrono::steady_clock::now() >= deadline))
+            {
+                return false;
+            }
+            // Read under the lock, so a change made after the check above moves the epoch
+            uint32_t seen = signal.epoch();
+            lock.unlock();
+            signal.template wait<Wait>(seen, st, deadline);
+            lock.lock();
+        }
+        return true;
+    }
+
+    // Waits are only timed when they actually block
+    bool wait_not_full(std::unique_lock<std::mutex>& lock, const std::stop_token& st,
+                       Deadline deadline = WaitSignal::NO_DEADLINE)
+    {
+        if (q.size() < max_len)
+        {
+            return true;
+        }
+        auto since = stats.now();
+        bool ready = await(lock, not_full_sig, [&] { return q.size() < max_len; }, st, deadline);
+        stats.onProducerBlocked(since);
+        return ready;
+    }
+
+    bool wait_not_empty(std::unique_lock<std::mutex>& lock, const std::stop_token& st,
+                        Deadline deadline = WaitSignal::NO_DEADLINE)
+    {
+        if (!q.empty())
+        {
+            return true;
+        }
+        auto since = stats.now();
+        bool ready = await(lock, not_empty_sig, [&] { return !q.empty(); }, st, deadline);
+        stats.onConsumerWaited(since);
+        return ready;
+    }
+
+    void push_locked(Telemetry&& data)
+    {
+        q.push_back(std::move(data));
+        stats.onPush(q.size());
+    }
+
+    Telemetry pop_locked(void)
+    {
+        Telemetry data = std::move(q.front());
+        q.pop_front();
+        stats.onPop(data.timestamp_ns);
+        return data;
+    }
+
+    size_t take_locked(size_t max_n, std::vector<Telemetry>& out, std::unique_lock<std::mutex>& lock)
+    {
+        size_t n = std::min(max_n, q.size());
+        for (size_t i = 0; i < n; ++i)
+        {
+            out.push_back(pop_locked());
+        }
+        lock.unlock();
+        if (n > 1)
+        {
+            not_full_sig.notify_all();
+        }
+        else
+        {
+            not_full_sig.notify_one();
+        }
+        return n;
+    }
 };
 
+using TelemetryQueue = BasicTelemetryQueue<>;
+
 #endif
@@ -0,0 +1,69 @@
+#ifndef TOPIC_REGISTRY_HPP
+#define TOPIC_REGISTRY_HPP
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+using TopicId = uint16_t;
+
+// Interns topic names ("imu", "gps", "power") to small dense ids so records carry two
+// bytes instead of a std::string, and per-topic dispatch is an array index.
+// intern() takes a lock and is meant for setup and rare new topics; name() and size()
+// are lock-free so writers can resolve ids on the hot path.
+class TopicRegistry
+{
+public:
+    static constexpr size_t MAX_TOPICS = 256;
+
+    static TopicRegistry& instance(void)
+    {
+        static TopicRegistry registry;
+        return registry;
+    }
+
+    TopicId intern(std::string_view name)
+    {
+        std::unique_lock<std::mutex> lock(m);
+        auto it = ids.find(std::string(name));
+        if (it != ids.end())
+        {
+            return it->second;
+        }
+        size_t id = count.load(std::memory_order_relaxed);
+        if (id >= MAX_TOPICS)
+        {
+            throw std::runtime_error("TopicRegistry is full, cannot intern " + std::string(name));
+        }
+        names[id] = std::string(name);
+        ids.emplace(names[id], static_cast<TopicId>(id));
+        // Publish the name before the id becomes visible to lock-free readers
+        count.store(id + 1, std::memory_order_release);
+        return static_cast<TopicId>(id);
+    }
+
+    const std::string& name(TopicId id) const
+    {
+        if (id >= count.load(std::memory_order_acquire))
+        {
+            throw std::out_of_range("Unknown topic id " + std::to_string(id));
+        }
+        return names[id];
+    }
+
+    size_t size(void) const { return count.load(std::memory_order_acquire); }
+
+private:
+    std::mutex m;
+    std::unordered_map<std::string, TopicId> ids;
+    // Fixed storage so a name's address never changes once published
+    std::array<std::string, MAX_TOPICS> names;
+    std::atomic<size_t> count{0};
+};
+
+#endif
@@ -0,0 +1,160 @@
+#ifndef WAIT_STRATEGY_HPP
+#define WAIT_STRATEGY_HPP
+
+#include <atomic>
+#include <chrono>
+#include <climits>
+#include <cstdint>
+#include <ctime>
+#include <stop_token>
+#include <thread>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+// How a thread waits for a queue condition. Each strategy spins for SPIN_TURNS turns, then
+// either keeps yielding the core (PARKS == false) or sleeps on a futex until it is
+// notified. Every wait also ends when its stop token is triggered.
+//
+//   BusySpin       never gives the core up; lowest latency for a pinned thread
+//   SpinThenYield  spins briefly, then yields; still makes progress on a single core
+//   SpinThenPark   spins briefly, then sleeps in the kernel; no CPU burned while idle
+
+struct BusySpin
+{
+    static constexpr unsigned SPIN_TURNS = UINT_MAX;
+    static constexpr bool PARKS = false;
+};
+
+template <unsigned Spins = 64>
+struct SpinThenYieldWait
+{
+    static constexpr unsigned SPIN_TURNS = Spins;
+    static constexpr bool PARKS = false;
+};
+
+template <unsigned Spins = 64>
+struct SpinThenParkWait
+{
+    static constexpr unsigned SPIN_TURNS = Spins;
+    static constexpr bool PARKS = true;
+};
+
+using SpinThenYield = SpinThenYieldWait<>;
+using SpinThenPark = SpinThenParkWait<>;
+
+inline void cpuRelax(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__)
+    asm volatile("yield");
+#endif
+}
+
+// Wake-up channel for one queue condition (not empty, not full). The state itself is
+// guarded by the queue's mutex; the signal only counts changes to it in a 32-bit futex
+// word. A waiter reads epoch() while it still holds the lock, so any change made after
+// that check moves the word and the wait returns. Bit 0 of the word is set by a thread
+// about to sleep; only a notify that clears it makes the wake syscall, so a producer
+// pushing into a queue whose consumer is already being woken stays in user space.
+class WaitSignal
+{
+public:
+    using Deadline = std::chrono::steady_clock::time_point;
+    static constexpr Deadline NO_DEADLINE = Deadline::max();
+
+    uint32_t epoch(void) const { return word.load(std::memory_order_acquire) & ~SLEEPERS; }
+
+    // Both wake every sleeper, since clearing the flag means nobody else would: waiters
+    // re-check the condition under the lock and go back to sleep if it is not met
+    void notify_one(void) { bump(); }
+    void notify_all(void) { bump(); }
+
+    // Returns once the word moves past seen, stop is requested or the deadline passes
+    template <typename Wait>
+    void wait(uint32_t seen, const std::stop_token &st, Deadline deadline = NO_DEADLINE)
+    {
+        for (unsigned turn = 0; epoch() == seen; ++turn)
+        {
+            if (turn < Wait::SPIN_TURNS)
+            {
+                // Only look at the clock and the token every so often while spinning
+                if (turn % 64 == 63 && expired(st, deadline))
+                {
+                    return;
+                }
+                cpuRelax();
+                continue;
+            }
+            if (expired(st, deadline))
+            {
+                return;
+            }
+            if constexpr (Wait::PARKS)
+            {
+                park(seen, st, deadline);
+            }
+            else
+            {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+private:
+    static constexpr uint32_t SLEEPERS = 1;
+    static constexpr uint32_t STEP = 2;
+
+    std::atomic<uint32_t> word{0};
+
+    static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t) && std::atomic<uint32_t>::is_always_lock_free,
+                  "the futex syscall needs a plain 32-bit word");
+
+    static bool expired(const std::stop_token &st, Deadline deadline)
+    {
+        return st.stop_requested() || (deadline != NO_DEADLINE && std::chrono::steady_clock::now() >= deadline);
+    }
+
+    void bump(void)
+    {
+        uint32_t old = word.load(std::memory_order_relaxed);
+        while (!word.compare_exchange_weak(old, (old + STEP) & ~SLEEPERS, std::memory_order_acq_rel,
+                                           std::memory_order_relaxed))
+        {
+        }
+        if (old & SLEEPERS)
+        {
+            ::syscall(SYS_futex, reinterpret_cast<uint32_t*>(&word), FUTEX_WAKE_PRIVATE, INT_MAX, nullptr, nullptr, 0);
+        }
+    }
+
+    void park(uint32_t seen, const std::stop_token &st, Deadline deadline)
+    {
+        // A stop request moves the word too, which wakes this and every other sleeper
+        std::stop_callback onStop(st, [this] { notify_all(); });
+        timespec timeout{};
+        timespec *rel = nullptr;
+        if (deadline != NO_DEADLINE)
+        {
+            auto left = std::chrono::duration_cast<std::chrono::nanoseconds>(deadline - std::chrono::steady_clock::now());
+            if (left.count() <= 0)
+            {
+                return;
+            }
+            timeout.tv_sec = static_cast<time_t>(left.count() / 1000000000);
+            timeout.tv_nsec = static_cast<long>(left.count() % 1000000000);
+            rel = &timeout;
+        }
+        // Either bump() sees the flag and wakes us, or it already moved the word and the
+        // kernel's compare against seen | SLEEPERS fails, so no notify is lost
+        uint32_t old = word.fetch_or(SLEEPERS, std::memory_order_acq_rel);
+        if ((old & ~SLEEPERS) != seen)
+        {
+            return;
+        }
+        ::syscall(SYS_futex, reinterpret_cast<uint32_t*>(&word), FUTEX_WAIT_PRIVATE, seen | SLEEPERS, rel, nullptr, 0);
+    }
+};
+
+#endif
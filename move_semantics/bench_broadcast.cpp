@@ -0,0 +1,161 @@
+#include <iostream>
+#include <thread>
+#include <chrono>
+#include <atomic>
+#include <memory>
+#include <vector>
+#include "TelemetryQueue.hpp"
+#include "SpscRingBuffer.hpp"
+#include "BroadcastRing.hpp"
+#define ALLOC_TRACKER_HOOK_NEW
+#include "../perfect_forwarding/AllocTracker.hpp"
+
+// Writer, validator and aggregator each see every record. "ring" runs them as subscribers
+// of one BroadcastRing, with the aggregator strictly after the validator; "queues" gives
+// each stage its own SpscRingBuffer and the producer pushes a copy into every one.
+
+using namespace std::chrono;
+
+const size_t RECORDS = 1000000;
+const size_t CAPACITY = 1024;
+const size_t BATCH = 64;
+const auto IDLE_POLL = milliseconds(10);
+const size_t PAYLOADS[] = {64, 1024};
+const TopicId IMU_TOPIC = TopicRegistry::instance().intern("imuFusedData");
+
+// Per-stage work, kept the same for both variants
+struct Stages {
+    uint64_t written = 0;     // writer: bytes it would have written
+    uint64_t outOfOrder = 0;  // validator: seq gaps
+    uint32_t lastSeq = 0;
+    uint64_t aggregate = 0;   // aggregator: running sum of the last payload byte
+
+    void write(const Telemetry &data) { written += data.payload.size(); }
+    void validate(const Telemetry &data)
+    {
+        outOfOrder += data.seq != lastSeq + 1;
+        lastSeq = data.seq;
+    }
+    void aggregateOne(const Telemetry &data) { aggregate += static_cast<uint8_t>(data.payload[data.payload.size() - 1]); }
+};
+
+static void fill(Telemetry &data, size_t i, size_t payload)
+{
+    data.timestamp_ns = i;
+    data.seq = static_cast<uint32_t>(i + 1);
+    data.topic_id = IMU_TOPIC;
+    data.payload.resize(payload);
+    data.payload[payload - 1] = std::byte(i);
+}
+
+static void report(const char *mode, size_t payload, steady_clock::duration elapsed, uint64_t allocs, const Stages &s)
+{
+    double secs = duration<double>(elapsed).count();
+    std::cout << mode << ',' << payload << ',' << static_cast<uint64_t>(RECORDS / secs) << ','
+              << static_cast<double>(allocs) / RECORDS << ',' << s.written << ',' << s.outOfOrder << ','
+              << s.aggregate << '\n';
+}
+
+void runRing(size_t payload)
+{
+    BroadcastRing<Telemetry> ring(CAPACITY);
+    auto &writer = ring.subscribe();
+    auto &validator = ring.subscribe();
+    auto &aggregator = ring.subscribe({&validator});
+    Stages s;
+    std::atomic<uint64_t> aheadOfValidator{0};
+
+    alloc_tracking::Scope scope;
+    auto start = steady_clock::now();
+    std::vector<std::thread> threads;
+    threads.emplace_back([&]() {
+        for (size_t n = 0; n < RECORDS;)
+        {
+            n += writer.poll_for(IDLE_POLL, [&](const Telemetry &data, uint64_t) { s.write(data); }, BATCH);
+        }
+    });
+    threads.emplace_back([&]() {
+        for (size_t n = 0; n < RECORDS;)
+        {
+            n += validator.poll_for(IDLE_POLL, [&](const Telemetry &data, uint64_t) { s.validate(data); }, BATCH);
+        }
+    });
+    threads.emplace_back([&]() {
+        for (size_t n = 0; n < RECORDS;)
+        {
+            n += aggregator.poll_for(IDLE_POLL, [&](const Telemetry &data, uint64_t seq) {
+                aheadOfValidator += validator.getPosition() <= seq;
+                s.aggregateOne(data);
+            }, BATCH);
+        }
+    });
+    for (size_t i = 0; i < RECORDS; ++i)
+    {
+        ring.publish_with([&](Telemetry &slot, uint64_t) { fill(slot, i, payload); });
+    }
+    for (auto &t : threads)
+    {
+        t.join();
+    }
+    report("ring", payload, steady_clock::now() - start, scope.counts().allocations, s);
+    if (aheadOfValidator)
+    {
+        std::cerr << "aggregator ran ahead of the validator " << aheadOfValidator << " times\n";
+    }
+}
+
+void runQueues(size_t payload)
+{
+    std::vector<std::unique_ptr<SpscRingBuffer<Telemetry>>> queues;
+    for (size_t c = 0; c < 3; ++c)
+    {
+        queues.push_back(std::make_unique<SpscRingBuffer<Telemetry>>(CAPACITY));
+    }
+    Stages s;
+
+    alloc_tracking::Scope scope;
+    auto start = steady_clock::now();
+    std::vector<std::thread> threads;
+    auto stage = [&](size_t c, auto work) {
+        return std::thread([&, c, work]() {
+            std::vector<Telemetry> batch;
+            batch.reserve(BATCH);
+            for (size_t n = 0; n < RECORDS;)
+            {
+                batch.clear();
+                n += queues[c]->pop_batch(BATCH, batch);
+                for (const auto &data : batch)
+                {
+                    work(data);
+                }
+            }
+        });
+    };
+    threads.push_back(stage(0, [&](const Telemetry &data) { s.write(data); }));
+    threads.push_back(stage(1, [&](const Telemetry &data) { s.validate(data); }));
+    threads.push_back(stage(2, [&](const Telemetry &data) { s.aggregateOne(data); }));
+    for (size_t i = 0; i < RECORDS; ++i)
+    {
+        Telemetry data;
+        fill(data, i, payload);
+        queues[0]->push_data_copy(data);
+        queues[1]->push_data_copy(data);
+        queues[2]->push_data(std::move(data));
+    }
+    for (auto &t : threads)
+    {
+        t.join();
+    }
+    report("queues", payload, steady_clock::now() - start, scope.counts().allocations, s);
+}
+
+int main(void)
+{
+    std::cout << "mode,payload,records_per_s,allocs_per_record,written_bytes,out_of_order,aggregate\n";
+    for (size_t payload : PAYLOADS)
+    {
+        runQueues(payload);
+        runRing(payload);
+    }
+    return 0;
+}
@@ -0,0 +1,97 @@
+#include <iostream>
+#include <thread>
+#include <chrono>
+#include <vector>
+#include <array>
+#include <atomic>
+#include <string>
+#include "TelemetryBus.hpp"
+
+// Throughput of TelemetryBus as consumer threads are added. One producer thread per topic
+// (imu, gps, power, ...) publishes concurrently; each consumer checksums payloads to stand in
+// for sink work and checks that every topic it sees arrives in seq order.
+
+using namespace std::chrono;
+
+const size_t RECORDS_PER_TOPIC = 100000;
+const size_t CAPACITY = 1024;
+const size_t PAYLOAD_SIZE = 256;
+const char *TOPIC_NAMES[] = {"imu", "gps", "power", "baro", "mag", "odom"};
+
+void runBenchmark(size_t consumers, const std::vector<TopicId> &topics)
+{
+    // Last seq seen per topic, one row per shard so consumers never share a row
+    std::vector<std::array<uint32_t, TopicRegistry::MAX_TOPICS>> lastSeq(consumers);
+    std::atomic<uint64_t> checksum{0};
+    std::atomic<uint64_t> outOfOrder{0};
+
+    auto start = steady_clock::now();
+    {
+        TelemetryBus bus(consumers, CAPACITY, [&](size_t shard, std::vector<Telemetry> &batch) {
+            uint64_t sum = 0;
+            for (const auto &data : batch)
+            {
+                uint32_t &last = lastSeq[shard][data.topic_id];
+                if (data.seq != last + 1)
+                {
+                    outOfOrder.fetch_add(1, std::memory_order_relaxed);
+                }
+                last = data.seq;
+                for (std::byte b : data.payload)
+                {
+                    sum += static_cast<uint8_t>(b);
+                }
+            }
+            checksum.fetch_add(sum, std::memory_order_relaxed);
+        });
+
+        std::vector<std::thread> producers;
+        for (TopicId topic : topics)
+        {
+            producers.emplace_back([&bus, topic]() {
+                for (size_t i = 0; i < RECORDS_PER_TOPIC; ++i)
+                {
+                    Telemetry data;
+                    data.timestamp_ns = duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+                    data.topic_id = topic;
+                    data.payload.resize(PAYLOAD_SIZE, std::byte(i));
+                    bus.publish(std::move(data));
+                }
+            });
+        }
+        for (auto &t : producers)
+        {
+            t.join();
+        }
+        bus.stop();
+    }
+    double secs = duration<double>(steady_clock::now() - start).count();
+
+    // Record i of every topic carries PAYLOAD_SIZE bytes of uint8_t(i)
+    uint64_t expected = 0;
+    for (size_t i = 0; i < RECORDS_PER_TOPIC; ++i)
+    {
+        expected += static_cast<uint8_t>(i);
+    }
+    expected *= PAYLOAD_SIZE * topics.size();
+    std::cout << consumers << " consumers: " << static_cast<uint64_t>(topics.size() * RECORDS_PER_TOPIC / secs)
+              << " records/s, out of order: " << outOfOrder.load() << ", checksum " << checksum.load()
+              << (checksum.load() == expected ? " ok" : " MISMATCH") << "\n";
+}
+
+int main(void)
+{
+    std::vector<TopicId> topics;
+    for (const char *name : TOPIC_NAMES)
+    {
+        topics.push_back(TopicRegistry::instance().intern(name));
+    }
+    size_t cores = std::max(1u, std::thread::hardware_concurrency());
+    std::cout << topics.size() << " topics x " << RECORDS_PER_TOPIC << " records, payload " << PAYLOAD_SIZE
+              << " bytes, " << cores << " cores\n";
+    for (size_t consumers = 1; consumers <= std::max<size_t>(cores, topics.size()); consumers *= 2)
+    {
+        runBenchmark(consumers, topics);
+    }
+    return 0;
+}
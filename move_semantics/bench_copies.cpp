@@ -0,0 +1,137 @@
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "TelemetryQueue.hpp"
+#include "SpscRingBuffer.hpp"
+#define ALLOC_TRACKER_HOOK_NEW
+#include "../perfect_forwarding/AllocTracker.hpp"
+
+// Deep copies and heap traffic per record on the producer -> queue -> consumer path, for a
+// freshly filled record pushed by move or by copy. Prints one CSV row per run and exits with
+// status 1 if a move path deep-copies, so it doubles as a check of the zero-copy claim.
+//   spsc:      SpscRingBuffer of a Counted record, copies and moves are counted directly
+//   telemetry: TelemetryQueue with heap payloads, a deep copy shows up as a second payload
+//              allocation per record; Telemetry is not Counted, so its copy and move
+//              columns are left empty
+
+const size_t RECORDS = 20000;
+const size_t CAPACITY = 256;
+const size_t PAYLOAD_SIZE = 1024;   // above the inline limit, so the payload is on the heap
+
+struct Record : alloc_tracking::Counted<Record>
+{
+    explicit Record(size_t size) : payload(size) {}
+
+    std::vector<std::byte> payload;
+};
+
+struct Row
+{
+    alloc_tracking::Counts n;
+    size_t records;
+    bool counted;   // the record type derives from Counted, so copies and moves mean something
+};
+
+void print(const char *queue, const char *variant, const Row &row)
+{
+    const double r = static_cast<double>(row.records);
+    std::cout << queue << ',' << variant << ',';
+    if (row.counted)
+    {
+        std::cout << row.n.copies / r << ',' << row.n.moves / r;
+    }
+    else
+    {
+        std::cout << ',';
+    }
+    std::cout << ',' << row.n.allocations / r << ',' << row.n.bytes / r << '\n';
+}
+
+Row runSpsc(bool copy)
+{
+    SpscRingBuffer<Record> q(CAPACITY);
+    alloc_tracking::Scope scope;
+    std::thread consumer([&q]() {
+        for (size_t i = 0; i < RECORDS; ++i)
+        {
+            Record r = q.pop_data();
+            if (r.payload.size() != PAYLOAD_SIZE)
+            {
+                std::cerr << "bad record\n";
+            }
+        }
+    });
+    for (size_t i = 0; i < RECORDS; ++i)
+    {
+        Record r(PAYLOAD_SIZE);
+        if (copy)
+        {
+            q.push_data_copy(r);
+        }
+        else
+        {
+            q.push_data(std::move(r));
+        }
+    }
+    consumer.join();
+    return Row{scope.counts(), RECORDS, true};
+}
+
+Row runTelemetry(bool copy)
+{
+    TelemetryQueue q(CAPACITY);
+    alloc_tracking::Scope scope;
+    std::thread consumer([&q]() {
+        for (size_t i = 0; i < RECORDS; ++i)
+        {
+            Telemetry d = q.pop_data();
+            if (d.payload.size() != PAYLOAD_SIZE)
+            {
+                std::cerr << "bad record\n";
+            }
+        }
+    });
+    for (size_t i = 0; i < RECORDS; ++i)
+    {
+        Telemetry d{};
+        d.seq = static_cast<uint32_t>(i);
+        d.payload.resize(PAYLOAD_SIZE);
+        if (copy)
+        {
+            q.push_data_copy(d);
+        }
+        else
+        {
+            q.push_data(std::move(d));
+        }
+    }
+    consumer.join();
+    return Row{scope.counts(), RECORDS, false};
+}
+
+int main(void)
+{
+    std::cout << "queue,variant,copies_per_record,moves_per_record,allocs_per_record,bytes_per_record\n";
+    Row spscMove = runSpsc(false);
+    print("spsc", "move", spscMove);
+    print("spsc", "copy", runSpsc(true));
+    Row telemetryMove = runTelemetry(false);
+    print("telemetry", "move", telemetryMove);
+    print("telemetry", "copy", runTelemetry(true));
+
+    bool ok = true;
+    if (spscMove.n.copies != 0)
+    {
+        std::cerr << "spsc move path made " << spscMove.n.copies << " deep copies\n";
+        ok = false;
+    }
+    // One payload buffer per record is the producer's own; a second one is a copy
+    if (telemetryMove.n.bytes >= 2 * PAYLOAD_SIZE * telemetryMove.records)
+    {
+        std::cerr << "telemetry move path allocated " << telemetryMove.n.bytes / telemetryMove.records
+                  << " bytes per record, payload copied\n";
+        ok = false;
+    }
+    return ok ? 0 : 1;
+}
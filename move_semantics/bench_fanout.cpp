@@ -0,0 +1,126 @@
+#include <iostream>
+#include <thread>
+#include <chrono>
+#include <atomic>
+#include <cstring>
+#include <memory>
+#include <vector>
+#include "TelemetryQueue.hpp"
+#include "SpscRingBuffer.hpp"
+#include "SharedPayload.hpp"
+#define ALLOC_TRACKER_HOOK_NEW
+#include "../perfect_forwarding/AllocTracker.hpp"
+
+// 1 -> N fan-out: one producer delivers every record to N consumers (disk writer,
+// dashboard, downsampler...), each reading from its own SpscRingBuffer. "copy" gives each
+// consumer its own deep copy of the Telemetry (the last one gets the original moved in),
+// "shared" allocates the payload once from a PayloadSlab and hands every consumer a
+// SharedTelemetry that refers to the same bytes.
+
+using namespace std::chrono;
+
+const size_t BYTES_PER_RUN = size_t(1) << 30;
+const size_t MAX_RECORDS = 200000;
+const size_t CAPACITY = 256;
+const size_t PAYLOADS[] = {256, 4096, 65536};
+const size_t CONSUMERS[] = {1, 2, 4, 8};
+const TopicId IMU_TOPIC = TopicRegistry::instance().intern("imuFusedData");
+
+struct Result {
+    double recordsPerSec;
+    double allocsPerRecord;
+    uint64_t checksum;
+};
+
+// Every sink reads the first and last byte, enough to pull the payload through the cache
+template <typename Record>
+static uint64_t touch(const Record &data)
+{
+    const std::byte *p = data.payload.data();
+    size_t n = data.payload.size();
+    return n == 0 ? 0 : static_cast<uint8_t>(p[0]) + static_cast<uint8_t>(p[n - 1]);
+}
+
+template <typename Record, typename Produce>
+Result run(size_t consumers, size_t records, Produce produce)
+{
+    std::vector<std::unique_ptr<SpscRingBuffer<Record>>> rings;
+    for (size_t c = 0; c < consumers; ++c)
+    {
+        rings.push_back(std::make_unique<SpscRingBuffer<Record>>(CAPACITY));
+    }
+    std::atomic<uint64_t> checksum{0};
+
+    alloc_tracking::Scope scope;
+    auto start = steady_clock::now();
+    std::vector<std::thread> threads;
+    for (size_t c = 0; c < consumers; ++c)
+    {
+        threads.emplace_back([&, c]() {
+            uint64_t sum = 0;
+            for (size_t i = 0; i < records; ++i)
+            {
+                Record data = rings[c]->pop_data();
+                sum += touch(data);
+            }
+            checksum.fetch_add(sum);
+        });
+    }
+    for (size_t i = 0; i < records; ++i)
+    {
+        produce(i, rings);
+    }
+    for (auto &t : threads)
+    {
+        t.join();
+    }
+    double secs = duration<double>(steady_clock::now() - start).count();
+    double allocs = static_cast<double>(scope.counts().allocations);
+    return {records / secs, allocs / records, checksum.load()};
+}
+
+int main(void)
+{
+    std::cout << "payload,consumers,mode,records_per_s,allocs_per_record,checksum\n";
+    for (size_t payload : PAYLOADS)
+    {
+        size_t records = std::min(MAX_RECORDS, BYTES_PER_RUN / payload);
+        // Enough blocks for a full ring plus one record held by each consumer and the producer
+        PayloadSlab slab(payload, 2 * CAPACITY + 16);
+
+        for (size_t consumers : CONSUMERS)
+        {
+            Result copied = run<Telemetry>(consumers, records, [&](size_t i, auto &rings) {
+                Telemetry data;
+                data.timestamp_ns = i;
+                data.seq = static_cast<uint32_t>(i);
+                data.topic_id = IMU_TOPIC;
+                data.payload.resize(payload, std::byte(i));
+                for (size_t c = 0; c + 1 < rings.size(); ++c)
+                {
+                    rings[c]->push_data_copy(data);
+                }
+                rings.back()->push_data(std::move(data));
+            });
+
+            Result shared = run<SharedTelemetry>(consumers, records, [&](size_t i, auto &rings) {
+                SharedTelemetry data{i, static_cast<uint32_t>(i), IMU_TOPIC, slab.allocate(payload)};
+                std::memset(data.payload.writable(), static_cast<int>(i & 0xff), payload);
+                for (size_t c = 0; c + 1 < rings.size(); ++c)
+                {
+                    rings[c]->push_data_copy(data);
+                }
+                rings.back()->push_data(std::move(data));
+            });
+
+            for (auto [mode, r] : {std::pair{"copy", copied}, std::pair{"shared", shared}})
+            {
+                std::cout << payload << ',' << consumers << ',' << mode << ','
+                          << static_cast<uint64_t>(r.recordsPerSec) << ','
+                          << r.allocsPerRecord << ',' << r.checksum << '\n';
+            }
+        }
+        std::cerr << "slab " << payload << " B: " << slab.hits() << " hits, " << slab.misses() << " misses\n";
+    }
+    return 0;
+}
@@ -0,0 +1,82 @@
+#include <iostream>
+#include <thread>
+#include <chrono>
+#include <atomic>
+#include <algorithm>
+#include <string>
+#include <vector>
+#include "TelemetryQueue.hpp"
+
+// Producer latency under sink backpressure for each TelemetryQueue overflow policy. The
+// consumer stalls for SINK_STALL after every batch, so it drains far slower than the
+// producer pushes and the queue is full most of the time. Prints records delivered, the
+// overflow counters, and push_data latency percentiles.
+
+using namespace std::chrono;
+
+const size_t RECORDS = 100000;
+const size_t CAPACITY = 256;
+const size_t BATCH = 32;
+const size_t PAYLOAD_SIZE = 64;
+const auto SINK_STALL = microseconds(200);
+const TopicId IMU_TOPIC = TopicRegistry::instance().intern("imuFusedData");
+
+void runBenchmark(const std::string &name, OverflowPolicy policy)
+{
+    TelemetryQueue q(CAPACITY, policy);
+    std::vector<uint64_t> latencies(RECORDS);
+    std::atomic<bool> done{false};
+    size_t delivered = 0;
+
+    std::thread consumer_thread([&]() {
+        std::vector<Telemetry> batch;
+        while (true)
+        {
+            batch.clear();
+            if (q.drain_for(milliseconds(10), batch, BATCH) == 0)
+            {
+                if (done)
+                {
+                    break;
+                }
+                continue;
+            }
+            delivered += batch.size();
+            std::this_thread::sleep_for(SINK_STALL);
+        }
+    });
+
+    auto start = steady_clock::now();
+    for (size_t i = 0; i < RECORDS; ++i)
+    {
+        Telemetry data;
+        data.seq = static_cast<uint32_t>(i);
+        data.topic_id = IMU_TOPIC;
+        data.payload.resize(PAYLOAD_SIZE);
+        auto t0 = steady_clock::now();
+        data.timestamp_ns = duration_cast<nanoseconds>(t0.time_since_epoch()).count();
+        q.push_data(std::move(data));
+        latencies[i] = duration_cast<nanoseconds>(steady_clock::now() - t0).count();
+    }
+    double producerSecs = duration<double>(steady_clock::now() - start).count();
+    done = true;
+    consumer_thread.join();
+
+    std::sort(latencies.begin(), latencies.end());
+    OverflowCounts c = q.getOverflowCounts();
+    std::cout << name << ',' << delivered << ',' << c.timed_out << ',' << c.dropped_newest << ','
+              << c.dropped_oldest << ',' << c.sampled_out << ',' << producerSecs << ','
+              << latencies[RECORDS / 2] << ',' << latencies[RECORDS * 99 / 100] << ',' << latencies.back() << '\n';
+}
+
+int main(void)
+{
+    std::cout << "policy,delivered,timed_out,dropped_newest,dropped_oldest,sampled_out,producer_s,"
+                 "push_p50_ns,push_p99_ns,push_max_ns\n";
+    runBenchmark("block", OverflowPolicy::block());
+    runBenchmark("block_for_50us", OverflowPolicy::blockFor(microseconds(50)));
+    runBenchmark("drop_newest", OverflowPolicy::dropNewest());
+    runBenchmark("drop_oldest", OverflowPolicy::dropOldest());
+    runBenchmark("sample_every_8", OverflowPolicy::sampleEvery(8));
+    return 0;
+}
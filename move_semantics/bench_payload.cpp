@@ -0,0 +1,87 @@
+#include <iostream>
+#include <thread>
+#include <chrono>
+#include "TelemetryQueue.hpp"
+#include "PayloadPool.hpp"
+#define ALLOC_TRACKER_HOOK_NEW
+#include "../perfect_forwarding/AllocTracker.hpp"
+
+// Mixed payload sizes (power readings, gps fixes, imu blobs) through a TelemetryQueue.
+// Each build runs once with fresh allocations and once with large payloads recycled
+// through PayloadPool. Built twice by the Makefile: bench_payload with the default inline threshold and
+// bench_payload_heap with TELEMETRY_INLINE_PAYLOAD_BYTES=0, i.e. every payload on the heap.
+
+using namespace std::chrono;
+
+const size_t RECORDS = 500000;
+const size_t CAPACITY = 1024;
+// Repeating mix: 10 power (48 B), 4 gps (96 B), 2 imu (4 KiB) out of every 16 records
+const size_t MIX[16] = {48, 48, 96, 48, 48, 4096, 48, 96, 48, 48, 96, 48, 4096, 48, 96, 48};
+
+const size_t MAX_PAYLOAD = 4096;
+
+// pooled: heap-backed payloads are recycled through PayloadPool instead of being
+// allocated and freed per record, which takes the allocator out of the comparison
+void run(bool pooled)
+{
+    const TopicId topic = TopicRegistry::instance().intern("mixed");
+    TelemetryQueue q(CAPACITY);
+    PayloadPool pool(2 * CAPACITY, MAX_PAYLOAD);
+    size_t inlineRecords = 0;
+    uint64_t checksum = 0;
+
+    auto start = steady_clock::now();
+    std::thread consumer_thread([&]() {
+        for (size_t i = 0; i < RECORDS; ++i)
+        {
+            Telemetry data = q.pop_data();
+            inlineRecords += data.payload.isInline();
+            checksum += static_cast<uint8_t>(data.payload[data.payload.size() - 1]);
+            if (pooled)
+            {
+                pool.release(data.payload.take_heap());
+            }
+        }
+    });
+    // Opened after the consumer's thread state is allocated; the consumer cannot pop, and
+    // so cannot allocate, until the first push below
+    alloc_tracking::Scope scope;
+    for (size_t i = 0; i < RECORDS; ++i)
+    {
+        Telemetry data;
+        data.seq = static_cast<uint32_t>(i);
+        data.topic_id = topic;
+        size_t size = MIX[i % 16];
+        if (pooled && size > TELEMETRY_INLINE_PAYLOAD_BYTES)
+        {
+            data.payload = pool.acquire();
+        }
+        data.payload.resize(size, std::byte(i));
+        q.push_data(std::move(data));
+    }
+    consumer_thread.join();
+    double secs = duration<double>(steady_clock::now() - start).count();
+    alloc_tracking::Counts n = scope.counts();
+    uint64_t allocs = n.allocations;
+    uint64_t bytes = n.bytes;
+
+    std::cout << (pooled ? "  pooled heap buffers" : "  fresh heap buffers") << "\n"
+              << "    heap allocations per record: " << static_cast<double>(allocs) / RECORDS
+              << ", heap bytes per record: " << static_cast<double>(bytes) / RECORDS << "\n";
+    if (pooled)
+    {
+        std::cout << "    pooled buffer memory: " << pool.misses() * MAX_PAYLOAD / 1024 << " KiB\n";
+    }
+    std::cout << "    inline records: " << 100.0 * inlineRecords / RECORDS << "%\n"
+              << "    throughput: " << static_cast<uint64_t>(RECORDS / secs) << " records/s"
+              << " (checksum " << checksum << ")\n";
+}
+
+int main(void)
+{
+    std::cout << "inline threshold " << TELEMETRY_INLINE_PAYLOAD_BYTES << " bytes, sizeof(Telemetry) "
+              << sizeof(Telemetry) << " bytes, queue slots " << CAPACITY * sizeof(Telemetry) / 1024 << " KiB\n";
+    run(false);
+    run(true);
+    return 0;
+}
@@ -0,0 +1,184 @@
+#include <iostream>
+#include <thread>
+#include <chrono>
+#include <vector>
+#include <algorithm>
+#include <atomic>
+#include <string>
+#include "TelemetryQueue.hpp"
+#include "SpscRingBuffer.hpp"
+#include "PayloadPool.hpp"
+#define ALLOC_TRACKER_HOOK_NEW
+#include "../perfect_forwarding/AllocTracker.hpp"
+
+// Move-vs-copy benchmark suite for the telemetry pipeline. Sweeps payload size, queue
+// capacity, producer/consumer count and push variant, and prints one CSV row per run with
+// throughput, push-to-pop latency percentiles and heap allocations per record.
+//
+// Variants:
+//   move       fill a fresh record and push_data(std::move(data))
+//   copy       keep one filled record and push_data_copy(data) every time
+//   move+pool  like move, but payload buffers come back through PayloadPool (SPSC only)
+
+using namespace std::chrono;
+
+const size_t RECORDS = 50000;
+const TopicId IMU_TOPIC = TopicRegistry::instance().intern("imuFusedData");
+
+enum class Variant { Move, Copy, MovePool };
+
+struct Config {
+    const char *queue;
+    Variant variant;
+    size_t payload;
+    size_t capacity;
+    size_t producers;
+    size_t consumers;
+};
+
+static uint64_t nowNs(void)
+{
+    return duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+static const char* variantName(Variant v)
+{
+    switch (v)
+    {
+        case Variant::Move: return "move";
+        case Variant::Copy: return "copy";
+        case Variant::MovePool: return "move+pool";
+    }
+    return "?";
+}
+
+template <typename Queue>
+void produce(Queue &q, const Config &cfg, size_t count, PayloadPool *pool)
+{
+    Telemetry data;
+    data.topic_id = IMU_TOPIC;
+    data.payload.resize(cfg.payload);
+    for (size_t i = 0; i < count; ++i)
+    {
+        if (cfg.variant != Variant::Copy)
+        {
+            // The previous payload was moved away
+            if (pool)
+            {
+                data.payload = pool->acquire();
+            }
+            data.payload.resize(cfg.payload);
+        }
+        data.seq = static_cast<uint32_t>(i);
+        data.timestamp_ns = nowNs();
+        if (cfg.variant == Variant::Copy)
+        {
+            q.push_data_copy(data);
+        }
+        else
+        {
+            q.push_data(std::move(data));
+        }
+    }
+}
+
+template <typename Queue>
+void consume(Queue &q, std::atomic<size_t> &remaining, std::vector<uint64_t> &latencies, PayloadPool *pool)
+{
+    std::vector<Telemetry> batch;
+    batch.reserve(32);
+    while (remaining.load(std::memory_order_relaxed) > 0)
+    {
+        size_t n = q.drain_for(milliseconds(1), batch, 32);
+        if (n == 0)
+        {
+            continue;
+        }
+        uint64_t now = nowNs();
+        for (auto &data : batch)
+        {
+            latencies.push_back(now - data.timestamp_ns);
+            if (pool)
+            {
+                pool->release(data.payload.take_heap());
+            }
+        }
+        batch.clear();
+        remaining.fetch_sub(n, std::memory_order_relaxed);
+    }
+}
+
+template <typename Queue>
+void run(const Config &cfg)
+{
+    Queue q(cfg.capacity);
+    PayloadPool pool(cfg.capacity + 64, cfg.payload);
+    PayloadPool *poolPtr = cfg.variant == Variant::MovePool ? &pool : nullptr;
+    std::vector<std::vector<uint64_t>> latencies(cfg.consumers);
+    for (auto &l : latencies)
+    {
+        l.reserve(RECORDS);
+    }
+    std::atomic<size_t> remaining{RECORDS};
+    std::vector<std::thread> threads;
+    threads.reserve(cfg.producers + cfg.consumers);
+
+    // Every allocation in the process is counted, the benchmark itself reserves up front so
+    // the scope only sees what the pipeline does
+    alloc_tracking::Scope scope;
+    auto start = steady_clock::now();
+    for (size_t c = 0; c < cfg.consumers; ++c)
+    {
+        threads.emplace_back([&, c]() { consume(q, remaining, latencies[c], poolPtr); });
+    }
+    for (size_t p = 0; p < cfg.producers; ++p)
+    {
+        size_t count = RECORDS / cfg.producers + (p < RECORDS % cfg.producers ? 1 : 0);
+        threads.emplace_back([&, count]() { produce(q, cfg, count, poolPtr); });
+    }
+    for (auto &t : threads)
+    {
+        t.join();
+    }
+    auto stop = steady_clock::now();
+    // Thread creation is a fixed cost per run, not per record
+    uint64_t allocs = scope.counts().allocations - cfg.producers - cfg.consumers;
+
+    std::vector<uint64_t> all;
+    all.reserve(RECORDS);
+    for (auto &l : latencies)
+    {
+        all.insert(all.end(), l.begin(), l.end());
+    }
+    std::sort(all.begin(), all.end());
+    double secs = duration<double>(stop - start).count();
+    std::cout << cfg.queue << "," << variantName(cfg.variant) << "," << cfg.payload << "," << cfg.capacity << ","
+              << cfg.producers << "," << cfg.consumers << "," << RECORDS << ","
+              << static_cast<uint64_t>(RECORDS / secs) << "," << all[all.size() / 2] << ","
+              << all[all.size() * 99 / 100] << "," << all[all.size() * 999 / 1000] << ","
+              << static_cast<double>(allocs) / RECORDS << "\n";
+}
+
+int main(void)
+{
+    std::cout << "queue,variant,payload_bytes,capacity,producers,consumers,records,"
+                 "records_per_s,p50_ns,p99_ns,p999_ns,allocs_per_record\n";
+    for (size_t payload : {64, 1024, 16384})
+    {
+        for (size_t capacity : {16, 1024})
+        {
+            for (Variant variant : {Variant::Move, Variant::Copy})
+            {
+                for (size_t threads : {1, 2, 4})
+                {
+                    run<TelemetryQueue>({"mutex", variant, payload, capacity, threads, threads});
+                }
+            }
+            for (Variant variant : {Variant::Move, Variant::Copy, Variant::MovePool})
+            {
+                run<SpscRingBuffer<Telemetry>>({"spsc", variant, payload, capacity, 1, 1});
+            }
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,67 @@
+#include <iostream>
+#include <thread>
+#include <chrono>
+#include <vector>
+#include <algorithm>
+#include <string>
+#include "TelemetryQueue.hpp"
+#include "SpscRingBuffer.hpp"
+
+// Throughput and latency comparison of the deque-and-mutex TelemetryQueue against the
+// lock-free SpscRingBuffer with one producer and one consumer thread.
+// Latency is measured from just before push_data to just after pop_data returns.
+
+using namespace std::chrono;
+
+const size_t RECORDS = 200000;
+const size_t CAPACITY = 1024;
+const size_t PAYLOAD_SIZE = 64;
+const TopicId IMU_TOPIC = TopicRegistry::instance().intern("imuFusedData");
+
+static uint64_t nowNs(void)
+{
+    return duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+template <typename Queue>
+void runBenchmark(const std::string &name)
+{
+    Queue q(CAPACITY);
+    std::vector<uint64_t> latencies(RECORDS);
+
+    auto start = steady_clock::now();
+    std::thread consumer_thread([&]() {
+        for (size_t i = 0; i < RECORDS; ++i)
+        {
+            Telemetry data = q.pop_data();
+            latencies[i] = nowNs() - data.timestamp_ns;
+        }
+    });
+
+    for (size_t i = 0; i < RECORDS; ++i)
+    {
+        Telemetry data;
+        data.seq = static_cast<uint32_t>(i);
+        data.topic_id = IMU_TOPIC;
+        data.payload.resize(PAYLOAD_SIZE);
+        data.timestamp_ns = nowNs();
+        q.push_data(std::move(data));
+    }
+    consumer_thread.join();
+    auto stop = steady_clock::now();
+
+    std::sort(latencies.begin(), latencies.end());
+    double secs = duration<double>(stop - start).count();
+    std::cout << name << ": " << static_cast<uint64_t>(RECORDS / secs) << " records/s"
+              << ", latency p50 " << latencies[RECORDS / 2] << " ns"
+              << ", p99 " << latencies[RECORDS * 99 / 100] << " ns"
+              << ", max " << latencies.back() << " ns\n";
+}
+
+int main(void)
+{
+    std::cout << RECORDS << " records, capacity " << CAPACITY << ", payload " << PAYLOAD_SIZE << " bytes\n";
+    runBenchmark<TelemetryQueue>("deque+mutex TelemetryQueue");
+    runBenchmark<SpscRingBuffer<Telemetry>>("lock-free SpscRingBuffer ");
+    return 0;
+}
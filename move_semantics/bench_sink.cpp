@@ -0,0 +1,61 @@
+#include <iostream>
+#include <chrono>
+#include <filesystem>
+#include <vector>
+#include "TelemetryLogWriter.hpp"
+
+// Sink throughput of TelemetryLogWriter for a few group-commit windows, so it can be
+// compared against the records/s the queues sustain in bench_queue.
+
+using namespace std::chrono;
+
+const size_t RECORDS = 200000;
+const size_t BATCH_SIZE = 32;
+const size_t PAYLOAD_SIZE = 1024;
+const TopicId IMU_TOPIC = TopicRegistry::instance().intern("imuFusedData");
+
+void runBenchmark(microseconds window)
+{
+    LogWriterConfig cfg;
+    cfg.directory = std::filesystem::temp_directory_path() / "bench_sink_log";
+    cfg.segment_bytes = 16ull << 20;
+    cfg.group_commit_window = window;
+    std::filesystem::remove_all(cfg.directory);
+
+    std::vector<Telemetry> batch(BATCH_SIZE);
+    for (auto &data : batch)
+    {
+        data.topic_id = IMU_TOPIC;
+        data.payload.resize(PAYLOAD_SIZE);
+    }
+
+    auto start = steady_clock::now();
+    {
+        TelemetryLogWriter writer(cfg);
+        for (size_t i = 0; i < RECORDS; i += BATCH_SIZE)
+        {
+            for (auto &data : batch)
+            {
+                data.seq = static_cast<uint32_t>(i);
+                data.timestamp_ns = duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+            }
+            writer.append(batch);
+        }
+        writer.flush();
+        double secs = duration<double>(steady_clock::now() - start).count();
+        const LogWriterStats &st = writer.stats();
+        std::cout << "group commit " << window.count() << " us: " << static_cast<uint64_t>(st.records / secs)
+                  << " records/s, " << st.bytes / secs / 1e6 << " MB/s, " << st.syncs << " fsyncs, "
+                  << st.segments << " segments\n";
+    }
+    std::filesystem::remove_all(cfg.directory);
+}
+
+int main(void)
+{
+    std::cout << RECORDS << " records in batches of " << BATCH_SIZE << ", payload " << PAYLOAD_SIZE << " bytes\n";
+    runBenchmark(microseconds(0));
+    runBenchmark(microseconds(2000));
+    runBenchmark(microseconds(20000));
+    return 0;
+}
@@ -3,19 +3,43 @@
 #include <chrono>
 #include <atomic>
 #include <csignal>
+#include <condition_variable>
+#include <mutex>
 #include "TelemetryQueue.hpp"
+#include "SpscRingBuffer.hpp"
+#include "PayloadPool.hpp"
+#include "TelemetryLogWriter.hpp"
+
+// Build with -DUSE_SPSC_QUEUE to swap in the lock-free single-producer/single-consumer ring
+#ifdef USE_SPSC_QUEUE
+using TelemetryQueueType = SpscRingBuffer<Telemetry>;
+#else
+using TelemetryQueueType = TelemetryQueue;
+#endif
 
 uint32_t last_sequence_num; // Telemetry data sequence number
 using namespace std::chrono;
 const int PAYLOAD_SIZE = 1024; // Simulated telemetry payload size received over the network
+const size_t BATCH_SIZE = 32; // Max records the consumer hands to the writer at once
+const TopicId IMU_TOPIC = TopicRegistry::instance().intern("imuFusedData");
+// Set by the SIGINT handler; a handler may only touch lock-free atomics, so main turns
+// it into stop requests for the worker threads
 std::atomic<bool> running;
-std::mutex m;
+std::atomic<bool> producerDone;
+
+void writingDataToFile(TelemetryLogWriter &writer, std::vector<Telemetry> &batch)
+{
+    // One vectored write for the whole batch, fsyncs are grouped by the writer
+    writer.append(batch);
+}
 
-void writingDataToFile(Telemetry &&data)
+void printSinkStats(const TelemetryLogWriter &writer, steady_clock::time_point start)
 {
-    std::cout << "Simulating writing data to file ts: " << data.timestamp_ns << " seq: " << data.seq << " topic: " << data.topic << "\n";
-    // Simulate writing to file taking longer
-    std::this_thread::sleep_for(std::chrono::milliseconds(50)); 
+    const LogWriterStats &st = writer.stats();
+    double secs = duration<double>(steady_clock::now() - start).count();
+    std::cout << "Sink wrote " << st.records << " records, " << st.bytes << " bytes in " << st.segments
+              << " segments with " << st.syncs << " fsyncs: " << static_cast<uint64_t>(st.records / secs)
+              << " records/s, " << st.bytes / secs / 1e6 << " MB/s\n";
 }
 
 void getTelemetryFromNetwork(Telemetry &data)
@@ -24,14 +48,16 @@ void getTelemetryFromNetwork(Telemetry &data)
     data.timestamp_ns = ns;
     last_sequence_num = (last_sequence_num + 1) % UINT32_MAX;
     data.seq = last_sequence_num;
-    data.topic = "imuFusedData";
+    data.topic_id = IMU_TOPIC;
+    // Sized once up front, no allocation when the buffer came from the pool
+    data.payload.resize(PAYLOAD_SIZE);
     for (uint32_t i = 0; i < PAYLOAD_SIZE; ++i)
     {
-        data.payload.emplace_back(std::byte(i % UINT8_MAX));
+        data.payload[i] = std::byte(i % UINT8_MAX);
     }
 }
 
-void producer_via_move(TelemetryQueue &q)
+void producer_via_move(std::stop_token st, TelemetryQueueType &q, PayloadPool &pool)
 {
     int i = 0;
     const int ITER = 100;
@@ -40,25 +66,26 @@ void producer_via_move(TelemetryQueue &q)
     auto start = steady_clock::now();
     while (i < ITER)
     {
-        std::unique_lock<std::mutex> lock(m);
-        if (!running)
+        // The previous payload was moved into the queue, take a recycled buffer
+        data.payload = pool.acquire();
+        // Get simulated telemetry data over the network;
+        getTelemetryFromNetwork(data);
+        // Push simulated data to queue, queue is implemented in a thread-safe maner.
+        // Only fails when a stop was requested while the queue was full.
+        if (st.stop_requested() || !q.push_data(std::move(data), st))
         {
             std::cout << "Producing thread is exiting" << "\n";
             return;
         }
-        lock.unlock();
-        // Get simulated telemetry data over the network;
-        getTelemetryFromNetwork(data);
-        // Push simulated data to queue, queue is implemented in a thread-safe maner
-        q.push_data(std::move(data));
         ++i;
     }
     auto stop  = steady_clock::now();
     auto ms = duration_cast<milliseconds>(stop - start).count();
     std::cout << "producing and pushing 100 elements in queue via move took " << ms << " ms\n";
+    std::cout << "payload pool hits: " << pool.hits() << " misses: " << pool.misses() << "\n";
 }
 
-void producer_via_copy(TelemetryQueue &q)
+void producer_via_copy(std::stop_token st, TelemetryQueueType &q, PayloadPool &)
 {
     int i = 0;
     const int ITER = 100;
@@ -67,40 +94,75 @@ void producer_via_copy(TelemetryQueue &q)
     auto start = steady_clock::now();
     while (i < ITER)
     {
-        std::unique_lock<std::mutex> lock(m);
-        if (!running)
+        // Get simulated telemetry data over the network;
+        getTelemetryFromNetwork(data);
+        // Push simulated data to queue, queue is implemented in a thread-safe maner.
+        // The copy is made explicitly so the push can still be cancelled.
+        Telemetry copy = data;
+        if (st.stop_requested() || !q.push_data(std::move(copy), st))
         {
             std::cout << "Producing thread is exiting" << "\n";
             return;
         }
-        lock.unlock();
-        // Get simulated telemetry data over the network;
-        getTelemetryFromNetwork(data);
-        // Push simulated data to queue, queue is implemented in a thread-safe maner
-        q.push_data_copy(data);
         ++i;
     }
     auto stop  = steady_clock::now();
     auto ms = duration_cast<milliseconds>(stop - start).count();
-    std::cout << "producing and pushing 100 elements in queue via move took " << ms << " ms\n";
+    std::cout << "producing and pushing 100 elements in queue via copy took " << ms << " ms\n";
 
 }
 
-void consumer(TelemetryQueue &q)
+void consumer(std::stop_token st, TelemetryQueueType &q, PayloadPool &pool)
 {
+    std::vector<Telemetry> batch;
+    batch.reserve(BATCH_SIZE);
+    // seq restarts at 1 every run, so a log spanning runs could not be searched by seq
+    LogWriterConfig cfg;
+    cfg.fresh_log = true;
+    TelemetryLogWriter writer(cfg);
+    auto start = steady_clock::now();
+    // Take everything queued (up to BATCH_SIZE) with one lock and one notify. Returns 0
+    // only once a stop was requested and the queue is drained.
+    while (q.pop_batch(BATCH_SIZE, batch, st) > 0)
+    {
+        writingDataToFile(writer, batch);
+        // Hand the drained buffers back to the producer instead of freeing them
+        for (auto &data : batch)
+        {
+            pool.release(data.payload.take_heap());
+        }
+        batch.clear();
+    }
+    writer.flush();
+    printSinkStats(writer, start);
+    std::cout << "Consuming thread is exiting" << "\n";
+}
+
+#if defined(TELEMETRY_QUEUE_STATS) && !defined(USE_SPSC_QUEUE)
+// Polls the queue's lock-free stats once a second until stopped; a stop request wakes it
+// at once, so main can join it before the queue goes away
+void monitor(std::stop_token stop, TelemetryQueueType &q)
+{
+    std::mutex m;
+    std::condition_variable_any cv;
+    std::unique_lock<std::mutex> lock(m);
     while (true)
     {
-        std::unique_lock<std::mutex> lock(m);
-        if (!running)
+        cv.wait_for(lock, stop, std::chrono::seconds(1), []() { return false; });
+        if (stop.stop_requested())
         {
-            std::cout << "Consuming thread is exiting" << "\n";
             return;
         }
-        lock.unlock();
-        // Get telemetry data from queue
-        writingDataToFile(std::move(q.pop_data()));
+        QueueStatsSnapshot st = q.getStats();
+        std::cout << "queue stats pushes: " << st.pushes << " pops: " << st.pops
+                  << " avg residency: " << (st.pops ? st.residency_total_ns / st.pops : 0) << " ns"
+                  << " max residency: " << st.residency_max_ns << " ns"
+                  << " producer blocked: " << st.producer_blocked_ns / 1000 << " us in " << st.producer_blocks << " waits"
+                  << " consumer waited: " << st.consumer_wait_ns / 1000 << " us in " << st.consumer_waits << " waits"
+                  << " occupancy high water: " << st.occupancy_high_water << "\n";
     }
 }
+#endif
 
 void handleSigint(int signum)
 {
@@ -113,14 +175,37 @@ void handleSigint(int signum)
 
 int main(void)
 {
-    TelemetryQueue telemetryQ(100);
+    TelemetryQueueType telemetryQ(100);
+    // Enough buffers for a full queue plus one consumer batch
+    PayloadPool payloadPool(256, PAYLOAD_SIZE);
     running = true;
+    producerDone = false;
     std::signal(SIGINT, handleSigint);
-    // Uncomment only one of the producers to show example
-    std::thread producer_thread(producer_via_move, std::ref(telemetryQ));
-    //std::thread producer_thread(producer_via_copy, std::ref(telemetryQ));
-    std::thread consumer_thread(consumer, std::ref(telemetryQ));
+    // jthreads pass each thread its own stop token as the first argument
+    auto produce = [&](std::stop_token st) {
+        // Uncomment only one of the producers to show example
+        producer_via_move(st, telemetryQ, payloadPool);
+        //producer_via_copy(st, telemetryQ, payloadPool);
+        producerDone = true;
+    };
+    std::jthread producer_thread(produce);
+    std::jthread consumer_thread(consumer, std::ref(telemetryQ), std::ref(payloadPool));
+#if defined(TELEMETRY_QUEUE_STATS) && !defined(USE_SPSC_QUEUE)
+    std::jthread monitor_thread(monitor, std::ref(telemetryQ));
+#endif
+    while (running && !producerDone)
+    {
+        std::this_thread::sleep_for(milliseconds(10));
+    }
+    // Stopping wakes a thread blocked in the queue at once; the consumer still drains what
+    // is already queued before it exits
+    producer_thread.request_stop();
     producer_thread.join();
+    consumer_thread.request_stop();
     consumer_thread.join();
+#if defined(TELEMETRY_QUEUE_STATS) && !defined(USE_SPSC_QUEUE)
+    monitor_thread.request_stop();
+    monitor_thread.join();
+#endif
     return 0;
 }
@@ -0,0 +1,44 @@
+#include <iostream>
+#include <string>
+#include <thread>
+#include <cstdint>
+#include "TelemetryQueue.hpp"
+#include "TelemetryLogReader.hpp"
+
+// Replays a time range of a telemetry log back through a TelemetryQueue.
+// Usage: ./replay [log_dir] [from_ns] [to_ns] [speed]
+// speed 1 keeps the original pace, 10 is ten times faster, 0 is as fast as possible.
+
+int main(int argc, char **argv)
+{
+    std::string dir = argc > 1 ? argv[1] : "telemetry_log";
+    uint64_t from_ns = argc > 2 ? std::stoull(argv[2]) : 0;
+    uint64_t to_ns = argc > 3 ? std::stoull(argv[3]) : UINT64_MAX;
+    double speed = argc > 4 ? std::stod(argv[4]) : 1.0;
+
+    TelemetryLogReader reader(dir);
+    std::cout << "Mapped " << reader.size() << " records from " << dir << "\n";
+    if (reader.skippedSegments() > 0)
+    {
+        std::cout << "Skipped " << reader.skippedSegments() << " segments that are empty or not telemetry logs\n";
+    }
+
+    TelemetryQueue q(100);
+    size_t expected = 0;
+    for (auto it = reader.seekTime(from_ns); it != reader.end() && (*it).timestamp_ns < to_ns; ++it)
+    {
+        ++expected;
+    }
+    std::thread consumer_thread([&]() {
+        for (size_t i = 0; i < expected; ++i)
+        {
+            Telemetry data = q.pop_data();
+            std::cout << "Replayed ts: " << data.timestamp_ns << " seq: " << data.seq << " topic: " << TopicRegistry::instance().name(data.topic_id)
+                      << " payload: " << data.payload.size() << " bytes\n";
+        }
+    });
+    size_t replayed = reader.replay(q, from_ns, to_ns, speed);
+    consumer_thread.join();
+    std::cout << "Replayed " << replayed << " records\n";
+    return 0;
+}
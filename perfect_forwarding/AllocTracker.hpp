@@ -0,0 +1,184 @@
+#ifndef ALLOC_TRACKER_HPP
+#define ALLOC_TRACKER_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+
+// Allocation and copy accounting for checking that a path really avoids deep copies.
+//
+// Exactly one translation unit defines ALLOC_TRACKER_HOOK_NEW before including this header;
+// that replaces the global operator new/delete with versions that count every heap
+// allocation in the process. Without it the allocation counters stay at zero.
+//
+// Types opt in to copy/move counting by deriving from Counted<T>; their copy and move
+// constructors and assignments (defaulted or calling the base's) are then counted, both per
+// type and in the process totals.
+//
+// A Scope snapshots the totals when created and reports what happened since, across all
+// threads, so it can span a producer, a queue and a consumer:
+//
+//     alloc_tracking::Scope scope;
+//     bar.addFoo(1, 2.0, "Hi", std::move(v));
+//     if (scope.counts().copies != 0) ...
+
+namespace alloc_tracking
+{
+
+struct Counts
+{
+    uint64_t allocations = 0;
+    uint64_t deallocations = 0;
+    uint64_t bytes = 0;        // requested by the allocations
+    uint64_t copies = 0;       // copy constructions and assignments of Counted types
+    uint64_t moves = 0;        // move constructions and assignments of Counted types
+
+    Counts operator-(const Counts &rhs) const
+    {
+        return Counts{allocations - rhs.allocations, deallocations - rhs.deallocations, bytes - rhs.bytes,
+                      copies - rhs.copies, moves - rhs.moves};
+    }
+};
+
+namespace detail
+{
+inline std::atomic<uint64_t> allocations{0};
+inline std::atomic<uint64_t> deallocations{0};
+inline std::atomic<uint64_t> bytes{0};
+inline std::atomic<uint64_t> copies{0};
+inline std::atomic<uint64_t> moves{0};
+
+inline void* allocate(size_t size)
+{
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    bytes.fetch_add(size, std::memory_order_relaxed);
+    if (void *p = std::malloc(size ? size : 1))
+    {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+inline void* allocateAligned(size_t size, std::align_val_t align)
+{
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    bytes.fetch_add(size, std::memory_order_relaxed);
+    const size_t a = static_cast<size_t>(align);
+    // aligned_alloc wants the size to be a multiple of the alignment
+    if (void *p = std::aligned_alloc(a, (size + a - 1) / a * a))
+    {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+inline void release(void *p) noexcept
+{
+    if (p)
+    {
+        deallocations.fetch_add(1, std::memory_order_relaxed);
+        std::free(p);
+    }
+}
+}
+
+inline Counts totals(void)
+{
+    return Counts{detail::allocations.load(std::memory_order_relaxed),
+                  detail::deallocations.load(std::memory_order_relaxed),
+                  detail::bytes.load(std::memory_order_relaxed), detail::copies.load(std::memory_order_relaxed),
+                  detail::moves.load(std::memory_order_relaxed)};
+}
+
+class Scope
+{
+public:
+    Scope() : mStart(totals()) {}
+
+    Counts counts(void) const { return totals() - mStart; }
+    void reset(void) { mStart = totals(); }
+
+private:
+    Counts mStart;
+};
+
+template <typename T>
+class Counted
+{
+public:
+    static uint64_t copies(void) { return sCopies.load(std::memory_order_relaxed); }
+    static uint64_t moves(void) { return sMoves.load(std::memory_order_relaxed); }
+
+protected:
+    Counted() = default;
+    ~Counted() = default;
+
+    Counted(const Counted&) noexcept { countCopy(); }
+    Counted(Counted&&) noexcept { countMove(); }
+
+    Counted& operator=(const Counted&) noexcept
+    {
+        countCopy();
+        return *this;
+    }
+
+    Counted& operator=(Counted&&) noexcept
+    {
+        countMove();
+        return *this;
+    }
+
+private:
+    inline static std::atomic<uint64_t> sCopies{0};
+    inline static std::atomic<uint64_t> sMoves{0};
+
+    static void countCopy(void)
+    {
+        sCopies.fetch_add(1, std::memory_order_relaxed);
+        detail::copies.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    static void countMove(void)
+    {
+        sMoves.fetch_add(1, std::memory_order_relaxed);
+        detail::moves.fetch_add(1, std::memory_order_relaxed);
+    }
+};
+
+}
+
+#ifdef ALLOC_TRACKER_HOOK_NEW
+// Replacement functions may not be inline, hence the one-translation-unit rule above.
+// noinline keeps GCC from pairing the inlined malloc()/free() with new/delete and warning.
+[[gnu::noinline]] void* operator new(size_t size) { return alloc_tracking::detail::allocate(size); }
+[[gnu::noinline]] void* operator new[](size_t size) { return alloc_tracking::detail::allocate(size); }
+[[gnu::noinline]] void* operator new(size_t size, std::align_val_t align)
+{
+    return alloc_tracking::detail::allocateAligned(size, align);
+}
+[[gnu::noinline]] void* operator new[](size_t size, std::align_val_t align)
+{
+    return alloc_tracking::detail::allocateAligned(size, align);
+}
+
+[[gnu::noinline]] void operator delete(void *p) noexcept { alloc_tracking::detail::release(p); }
+[[gnu::noinline]] void operator delete[](void *p) noexcept { alloc_tracking::detail::release(p); }
+[[gnu::noinline]] void operator delete(void *p, size_t) noexcept { alloc_tracking::detail::release(p); }
+[[gnu::noinline]] void operator delete[](void *p, size_t) noexcept { alloc_tracking::detail::release(p); }
+[[gnu::noinline]] void operator delete(void *p, std::align_val_t) noexcept { alloc_tracking::detail::release(p); }
+[[gnu::noinline]] void operator delete[](void *p, std::align_val_t) noexcept
+{
+    alloc_tracking::detail::release(p);
+}
+[[gnu::noinline]] void operator delete(void *p, size_t, std::align_val_t) noexcept
+{
+    alloc_tracking::detail::release(p);
+}
+[[gnu::noinline]] void operator delete[](void *p, size_t, std::align_val_t) noexcept
+{
+    alloc_tracking::detail::release(p);
+}
+#endif
+
+#endif
@@ -0,0 +1,143 @@
+#ifndef BAR_HPP
+#define BAR_HPP
+
+#include <iostream>
+#include <memory>
+#include <memory_resource>
+#include <ranges>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "AllocTracker.hpp"
+
+// Build with -DFOO_QUIET to drop foo's constructor/destructor trace, e.g. for benchmarks
+#ifdef FOO_QUIET
+#define FOO_TRACE(msg)
+#else
+#define FOO_TRACE(msg) std::cout << msg
+#endif
+
+// foo's string and vector use Alloc. foo itself is the plain std::string/std::vector<int>
+// one; pmr_foo's members take their memory from the polymorphic allocator it is built with,
+// so an ArenaBar keeps every member in its arena. Containers using a polymorphic_allocator
+// pass theirs as the trailing argument.
+// Counted lets the allocation tracker count copies and moves of foo.
+template <typename Alloc>
+struct basic_foo : alloc_tracking::Counted<basic_foo<Alloc>> {
+    using allocator_type = Alloc;
+    using string_type = std::basic_string<char, std::char_traits<char>,
+                                          typename std::allocator_traits<Alloc>::template rebind_alloc<char>>;
+    using vector_type = std::vector<int, typename std::allocator_traits<Alloc>::template rebind_alloc<int>>;
+
+    int a;
+    double b;
+    string_type c;
+    vector_type v;
+
+    basic_foo(int a_value = 0, double b_value = 0.0, std::string_view c_value = "", const vector_type& v_vec = {0},
+              const allocator_type& alloc = {})
+        : a(a_value), b(b_value), c(c_value, alloc), v(v_vec, alloc) {    FOO_TRACE("Vector was constructed from l-value\n"); }
+
+    // Takes the caller's buffer: a named rvalue reference is an lvalue, so it needs std::move,
+    // and a const&& could not be moved from at all. A pmr buffer is only taken over when it
+    // came from the same resource, otherwise it is copied into ours.
+    basic_foo(int a_value = 0, double b_value = 0.0, std::string_view c_value = "", vector_type&& v_vec = {0},
+              const allocator_type& alloc = {})
+        : a(a_value), b(b_value), c(c_value, alloc), v(std::move(v_vec), alloc) {    FOO_TRACE("Vector was constructed from r-value\n"); }
+
+    // The user-declared destructor suppresses the implicit move constructor, without these
+    // every reallocation of Bar's vector would deep-copy each foo
+    basic_foo(const basic_foo&) = default;
+    basic_foo(basic_foo&&) noexcept = default;
+    basic_foo& operator=(const basic_foo&) = default;
+    basic_foo& operator=(basic_foo&&) noexcept = default;
+
+    // Used when a pmr container relocates a foo into its own resource
+    basic_foo(const basic_foo& other, const allocator_type& alloc)
+        : Counted(other), a(other.a), b(other.b), c(other.c, alloc), v(other.v, alloc) {}
+    basic_foo(basic_foo&& other, const allocator_type& alloc)
+        : Counted(std::move(other)), a(other.a), b(other.b), c(std::move(other.c), alloc), v(std::move(other.v), alloc) {}
+
+    ~basic_foo() {
+        FOO_TRACE("Destroying foo\n");
+    }
+
+    void print() const {
+        std::cout << "a: " << a << ", b: " << b << ", c: \"" << c << "\"\n";
+    }
+
+private:
+    using Counted = alloc_tracking::Counted<basic_foo>;
+};
+
+using foo = basic_foo<std::allocator<void>>;
+using pmr_foo = basic_foo<std::pmr::polymorphic_allocator<>>;
+
+// Bar keeps its foos on the global heap, one allocation per member. ArenaBar carves the
+// foos and their members from blocks it owns, starting at initialBytes and growing
+// geometrically, and releases them all at once when it is destroyed. Nothing is freed
+// before that, so reserve() up front: otherwise every outgrown foo array stays in the
+// arena until the end.
+template <typename Alloc>
+struct BasicBar
+{
+    using value_type = basic_foo<Alloc>;
+    static constexpr bool ARENA = std::is_same_v<Alloc, std::pmr::polymorphic_allocator<>>;
+
+    BasicBar() requires (!ARENA) = default;
+
+    explicit BasicBar(size_t initialBytes = 64 * 1024) requires ARENA
+        : mArena(std::make_unique<std::pmr::monotonic_buffer_resource>(initialBytes)), v(mArena.get())
+    {
+    }
+
+    BasicBar(BasicBar&&) = default;
+    BasicBar& operator=(BasicBar&&) = delete;
+
+    template <typename... Args>
+    void addFoo(Args&& ...args)
+    {
+        v.emplace_back(std::forward<Args>(args)...);
+    }
+
+    // Adds one foo per element, reserving first when the range knows its size. An element
+    // is either a foo constructor's argument or a tuple of its arguments.
+    template <std::ranges::input_range R>
+    void addFoos(R&& range)
+    {
+        if constexpr (std::ranges::sized_range<R>)
+        {
+            reserve(v.size() + std::ranges::size(range));
+        }
+        for (auto&& elem : range)
+        {
+            using Elem = decltype(elem);
+            if constexpr (std::is_constructible_v<value_type, Elem>)
+            {
+                v.emplace_back(std::forward<Elem>(elem));
+            }
+            else
+            {
+                std::apply([this](auto&& ...args) { v.emplace_back(std::forward<decltype(args)>(args)...); },
+                           std::forward<Elem>(elem));
+            }
+        }
+    }
+
+    void reserve(size_t n) { v.reserve(n); }
+    size_t size() const { return v.size(); }
+    const value_type& operator[](size_t i) const { return v[i]; }
+
+private:
+    // Declared before v so the arena outlives the foos it holds; null for a heap Bar
+    std::unique_ptr<std::pmr::monotonic_buffer_resource> mArena;
+    std::vector<value_type, typename std::allocator_traits<Alloc>::template rebind_alloc<value_type>> v;
+};
+
+using Bar = BasicBar<std::allocator<void>>;
+using ArenaBar = BasicBar<std::pmr::polymorphic_allocator<>>;
+
+#endif
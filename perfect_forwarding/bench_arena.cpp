@@ -0,0 +1,85 @@
+#include <iostream>
+#include <algorithm>
+#include <chrono>
+#include <ranges>
+#include <string_view>
+#include <tuple>
+#include <vector>
+#define ALLOC_TRACKER_HOOK_NEW
+#include "AllocTracker.hpp"
+#include "Bar.hpp"
+
+// Build and teardown time of a Bar holding FOOS foos, each with a heap-sized string and a
+// four-int vector, in a heap Bar and an ArenaBar, with and without reserving up front.
+// Prints one CSV row per mode with the best of RUNS runs and heap allocations per foo.
+// Build with -DFOO_QUIET (the Makefile does) so foo does not trace.
+
+using namespace std::chrono;
+
+const int FOOS = 1000000;
+const int RUNS = 3;
+const std::string_view NAME = "telemetry-sensor-name-long";
+
+enum class Mode { Heap, HeapReserve, Arena, ArenaAddFoos };
+
+// Builds FOOS foos into a fresh Bar, returns it for teardown
+template <typename BarType>
+BarType buildBar(Mode mode)
+{
+    const typename BarType::value_type::vector_type ints = {1, 2, 3, 4};
+    BarType bar;
+    if (mode == Mode::ArenaAddFoos)
+    {
+        bar.addFoos(std::views::iota(0, FOOS) | std::views::transform([&ints](int i) {
+            return std::tuple<int, double, std::string_view, decltype(ints)&>(i, i * 0.5, NAME, ints);
+        }));
+    }
+    else
+    {
+        if (mode == Mode::HeapReserve)
+        {
+            bar.reserve(FOOS);
+        }
+        for (int i = 0; i < FOOS; ++i)
+        {
+            bar.addFoo(i, i * 0.5, NAME, ints);
+        }
+    }
+    return bar;
+}
+
+template <typename Build>
+void runBenchmark(const char *name, Build build)
+{
+    double bestBuild = 1e30;
+    double bestTeardown = 1e30;
+    uint64_t allocations = 0;
+    for (int run = 0; run < RUNS; ++run)
+    {
+        alloc_tracking::Scope scope;
+        auto t0 = steady_clock::now();
+        {
+            auto foos = build();
+            if (foos.size() != static_cast<size_t>(FOOS) || foos[FOOS - 1].a != FOOS - 1)
+            {
+                std::cerr << "bad build\n";
+            }
+            bestBuild = std::min(bestBuild, duration<double, std::milli>(steady_clock::now() - t0).count());
+            allocations = scope.counts().allocations;
+            t0 = steady_clock::now();
+        }
+        bestTeardown = std::min(bestTeardown, duration<double, std::milli>(steady_clock::now() - t0).count());
+    }
+    std::cout << name << ',' << FOOS << ',' << bestBuild << ',' << bestTeardown << ','
+              << static_cast<double>(allocations) / FOOS << '\n';
+}
+
+int main(void)
+{
+    std::cout << "mode,foos,build_ms,teardown_ms,allocs_per_foo\n";
+    runBenchmark("heap", [] { return buildBar<Bar>(Mode::Heap); });
+    runBenchmark("heap_reserve", [] { return buildBar<Bar>(Mode::HeapReserve); });
+    runBenchmark("arena", [] { return buildBar<ArenaBar>(Mode::Arena); });
+    runBenchmark("arena_addFoos", [] { return buildBar<ArenaBar>(Mode::ArenaAddFoos); });
+    return 0;
+}
@@ -1,38 +1,18 @@
 #include <iostream>
+#include <array>
+#include <tuple>
 #include <vector>
 #include <utility>
+#define ALLOC_TRACKER_HOOK_NEW
+#include "AllocTracker.hpp"
+#include "Bar.hpp"
 
-struct foo {
-    int a;
-    double b;
-    std::string c;
-    std::vector<int> v;
-
-    foo(int a_value = 0, double b_value = 0.0, const std::string& c_value = "", const std::vector<int>& v_vec = {0})
-        : a(a_value), b(b_value), c(c_value), v(v_vec) {    std::cout << "Vector was constructed from l-value\n"; }
-
-    foo(int a_value = 0, double b_value = 0.0, const std::string& c_value = "", const std::vector<int>&& v_vec = {0})
-        : a(a_value), b(b_value), c(c_value), v(v_vec) {    std::cout << "Vector was constructed from r-value\n"; }
-    ~foo() {
-        std::cout << "Destroying foo\n";
-    }
-
-    void print() const {
-        std::cout << "a: " << a << ", b: " << b << ", c: \"" << c << "\"\n";
-    }
-};
-
-
-struct Bar
+void printCounts(const char *what, const alloc_tracking::Scope &scope)
 {
-    template <typename... Args>
-    void addFoo(Args&& ...args)
-    {
-        v.emplace_back(std::forward<Args>(args)...);
-    }
-private:
-    std::vector<foo> v;
-};
+    alloc_tracking::Counts n = scope.counts();
+    std::cout << what << ": " << n.allocations << " allocations, " << n.bytes << " bytes, " << n.copies
+              << " foo copies, " << n.moves << " foo moves\n";
+}
 
 int main(void)
 {
@@ -42,10 +22,45 @@ int main(void)
     // addFoo method uses perfect forwarding to preserve the argument type
     // When we construct the vector in the storage of the Bar object, this will invoke
     // foo's constructor where the vector is constructed from an l-value reference 
+    alloc_tracking::Scope scope;
     b.addFoo(1, 2.0, "Hello", v);
+    // Bar's storage plus the copy of v
+    printCounts("addFoo(l-value vector)", scope);
 
     Bar c;
     std::vector<int> v2 = {1,2,3};
+    scope.reset();
     c.addFoo(2,3.0, "Hi", std::move(v2));
+    // Only Bar's storage, v2's buffer now belongs to the foo
+    printCounts("addFoo(r-value vector)", scope);
+    const alloc_tracking::Counts rvalue = scope.counts();
+
+    // Growing Bar's vector moves the existing foos instead of copying them
+    scope.reset();
+    for (int i = 0; i < 4; ++i)
+    {
+        c.addFoo(i, 1.0, "Grow", std::vector<int>{i});
+    }
+    printCounts("addFoo x4 with growth", scope);
+
+    // In an ArenaBar the foos, their strings and vectors all come out of the Bar's arena:
+    // the arena and its first block are allocated once, the foos add nothing
+    std::pmr::vector<int> pv(v.begin(), v.end());
+    scope.reset();
+    ArenaBar d(4096);
+    d.reserve(3);
+    d.addFoos(std::array<std::tuple<int, double, const char*, const std::pmr::vector<int>&>, 3>{{
+        {1, 1.0, "a string too long for the small-string buffer", pv},
+        {2, 2.0, "another string too long for the small-string buffer", pv},
+        {3, 3.0, "Short", pv}}});
+    printCounts("arena addFoos x3", scope);
+
+    // A copied vector buffer shows up as a second allocation, a copied foo as a copy
+    if (rvalue.allocations != 1 || rvalue.copies != 0)
+    {
+        std::cerr << "addFoo(r-value vector) made " << rvalue.allocations << " allocations and "
+                  << rvalue.copies << " foo copies, expected 1 and 0\n";
+        return 1;
+    }
     return 0;
 }
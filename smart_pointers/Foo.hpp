@@ -0,0 +1,38 @@
+#ifndef FOO_HPP
+#define FOO_HPP
+
+#include <iostream>
+#include <string>
+
+// Build with -DFOO_QUIET to drop the destruction trace, e.g. for benchmarks
+#ifdef FOO_QUIET
+#define FOO_TRACE(msg)
+#else
+#define FOO_TRACE(msg) std::cout << msg
+#endif
+
+struct foo {
+    int a;
+    double b;
+    std::string c;
+
+    foo(int a_value = 0, double b_value = 0.0, const std::string& c_value = "")
+        : a(a_value), b(b_value), c(c_value) {}
+
+    ~foo() {
+        FOO_TRACE("Destroying foo\n");
+    }
+
+    void print() const {
+        std::cout << "a: " << a << ", b: " << b << ", c: \"" << c << "\"\n";
+    }
+};
+
+struct foo_deleter {
+    void operator()(foo* p) const {
+        FOO_TRACE("foo_deleter invoked\n");
+        delete p;
+    }
+};
+
+#endif
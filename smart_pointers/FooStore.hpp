@@ -0,0 +1,305 @@
+#ifndef FOO_STORE_HPP
+#define FOO_STORE_HPP
+
+#include <bit>
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "Foo.hpp"
+
+// foos stored column by column: all the a's in one contiguous array, all the b's in another,
+// the strings in a third. A filter on a or an aggregate over b streams through one dense
+// column instead of following a pointer per element to a foo somewhere on the heap.
+//
+// The kernels work on one 16 byte vector (4 ints, 2 doubles) at a time with GCC vector
+// extensions, which map to SSE2 on plain x86-64 without intrinsics. Predicates are
+// generic lambdas using comparisons and & | ~, so the same code runs on a whole lane vector
+// or, for the tail, on one value:
+//
+//     store.erase_if_a([](auto a) { return a < 3; });
+//
+// A predicate that only accepts a scalar still works, element by element.
+
+namespace foo_store_detail
+{
+constexpr size_t VECTOR_BYTES = 16;
+
+template <typename T>
+constexpr size_t LANES = VECTOR_BYTES / sizeof(T);
+
+template <typename T>
+using Lanes [[gnu::vector_size(VECTOR_BYTES)]] = T;
+
+template <typename T>
+Lanes<T> load(const T *p)
+{
+    Lanes<T> v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+// Runs pred on LANES elements at once when it accepts a lane vector and returns a lane mask
+template <typename T, typename Pred>
+constexpr bool lanewise = std::is_invocable_v<Pred&, Lanes<T>> &&
+                          !std::is_convertible_v<std::invoke_result_t<Pred&, Lanes<T>>, bool>;
+
+// Bit j set where lane j of a comparison result is true (all ones)
+template <typename T, typename Mask>
+unsigned laneBits(const Mask &m)
+{
+    unsigned bits = 0;
+    for (size_t j = 0; j < LANES<T>; ++j)
+    {
+        bits |= static_cast<unsigned>(m[j] & 1) << j;
+    }
+    return bits;
+}
+}
+
+class FooStore
+{
+public:
+    FooStore() = default;
+
+    // Adapter for the unique_ptr-based code: copies the foos the pointers own, skipping nulls.
+    // Works for any range of pointer-likes (unique_ptr with any deleter, shared_ptr, foo*).
+    template <typename Pointers>
+    static FooStore from_pointers(const Pointers &ptrs)
+    {
+        FooStore store;
+        store.reserve(std::size(ptrs));
+        for (const auto &p : ptrs)
+        {
+            if (p)
+            {
+                store.push_back(*p);
+            }
+        }
+        return store;
+    }
+
+    std::vector<std::unique_ptr<foo>> to_pointers() const
+    {
+        std::vector<std::unique_ptr<foo>> out;
+        out.reserve(size());
+        for (size_t i = 0; i < size(); ++i)
+        {
+            out.push_back(std::make_unique<foo>(mA[i], mB[i], mC[i]));
+        }
+        return out;
+    }
+
+    void push_back(const foo &f) { emplace_back(f.a, f.b, f.c); }
+
+    void emplace_back(int a, double b, std::string c)
+    {
+        mA.push_back(a);
+        mB.push_back(b);
+        mC.push_back(std::move(c));
+    }
+
+    void reserve(size_t n)
+    {
+        mA.reserve(n);
+        mB.reserve(n);
+        mC.reserve(n);
+    }
+
+    void clear(void)
+    {
+        mA.clear();
+        mB.clear();
+        mC.clear();
+    }
+
+    size_t size(void) const { return mA.size(); }
+    bool empty(void) const { return mA.empty(); }
+
+    // Builds a foo from row i
+    foo at(size_t i) const
+    {
+        if (i >= size())
+        {
+            throw std::out_of_range("FooStore::at index out of range");
+        }
+        return foo(mA[i], mB[i], mC[i]);
+    }
+
+    std::span<const int> a(void) const { return mA; }
+    std::span<const double> b(void) const { return mB; }
+    std::span<const std::string> c(void) const { return mC; }
+
+    // Remove the rows whose a (or b) matches pred, keeping the others in order, in place.
+    // Return how many were removed.
+    template <typename Pred>
+    size_t erase_if_a(Pred pred) { return eraseWhere(mA, pred); }
+
+    template <typename Pred>
+    size_t erase_if_b(Pred pred) { return eraseWhere(mB, pred); }
+
+    template <typename Pred>
+    size_t count_if_a(Pred pred) const
+    {
+        using namespace foo_store_detail;
+        const size_t n = size();
+        size_t i = 0;
+        size_t count = 0;
+        if constexpr (lanewise<int, Pred>)
+        {
+            for (; i + LANES<int> <= n; i += LANES<int>)
+            {
+                count += std::popcount(laneBits<int>(pred(load(&mA[i]))));
+            }
+        }
+        for (; i < n; ++i)
+        {
+            count += pred(mA[i]) ? 1 : 0;
+        }
+        return count;
+    }
+
+    // Summed in UNROLL * 2 interleaved partial sums, so the result can differ from a
+    // left-to-right sum in the last bits
+    double sum_b(void) const
+    {
+        using namespace foo_store_detail;
+        constexpr size_t STEP = UNROLL * LANES<double>;
+        const size_t n = size();
+        Lanes<double> acc[UNROLL] = {};
+        size_t i = 0;
+        for (; i + STEP <= n; i += STEP)
+        {
+            for (size_t u = 0; u < UNROLL; ++u)
+            {
+                acc[u] += load(&mB[i + u * LANES<double>]);
+            }
+        }
+        double sum = 0.0;
+        for (size_t u = 0; u < UNROLL; ++u)
+        {
+            for (size_t j = 0; j < LANES<double>; ++j)
+            {
+                sum += acc[u][j];
+            }
+        }
+        for (; i < n; ++i)
+        {
+            sum += mB[i];
+        }
+        return sum;
+    }
+
+    double min_b(void) const
+    {
+        return reduceB("FooStore::min_b on an empty store", [](auto x, auto m) { return x < m ? x : m; });
+    }
+
+    double max_b(void) const
+    {
+        return reduceB("FooStore::max_b on an empty store", [](auto x, auto m) { return x > m ? x : m; });
+    }
+
+private:
+    // Independent accumulators in the b reductions, enough to hide the add latency
+    static constexpr size_t UNROLL = 4;
+
+    std::vector<int> mA;
+    std::vector<double> mB;
+    std::vector<std::string> mC;
+
+    // The hot columns are written unconditionally at the compacted position, which never
+    // passes the one being read; a chunk that keeps everything while nothing has been
+    // removed yet is skipped without writes
+    template <typename T, typename Pred>
+    size_t eraseWhere(const std::vector<T> &col, Pred &pred)
+    {
+        using namespace foo_store_detail;
+        const size_t n = size();
+        size_t kept = 0;
+        size_t i = 0;
+        if constexpr (lanewise<T, Pred>)
+        {
+            for (; i + LANES<T> <= n; i += LANES<T>)
+            {
+                const unsigned drop = laneBits<T>(pred(load(&col[i])));
+                if (drop == 0 && kept == i)
+                {
+                    kept += LANES<T>;
+                    continue;
+                }
+                for (size_t j = 0; j < LANES<T>; ++j)
+                {
+                    kept = keepRow(i + j, kept, !((drop >> j) & 1));
+                }
+            }
+        }
+        for (; i < n; ++i)
+        {
+            kept = keepRow(i, kept, !pred(col[i]));
+        }
+        mA.resize(kept);
+        mB.resize(kept);
+        mC.resize(kept);
+        return n - kept;
+    }
+
+    size_t keepRow(size_t from, size_t to, bool keep)
+    {
+        mA[to] = mA[from];
+        mB[to] = mB[from];
+        if (keep && to != from)
+        {
+            mC[to] = std::move(mC[from]);
+        }
+        return to + (keep ? 1 : 0);
+    }
+
+    template <typename Pick>
+    double reduceB(const char *emptyError, Pick pick) const
+    {
+        using namespace foo_store_detail;
+        const size_t n = size();
+        if (n == 0)
+        {
+            throw std::runtime_error(emptyError);
+        }
+        constexpr size_t STEP = UNROLL * LANES<double>;
+        size_t i = 0;
+        double result = mB[0];
+        if (n >= STEP)
+        {
+            Lanes<double> acc[UNROLL];
+            for (size_t u = 0; u < UNROLL; ++u)
+            {
+                acc[u] = load(&mB[u * LANES<double>]);
+            }
+            for (i = STEP; i + STEP <= n; i += STEP)
+            {
+                for (size_t u = 0; u < UNROLL; ++u)
+                {
+                    acc[u] = pick(load(&mB[i + u * LANES<double>]), acc[u]);
+                }
+            }
+            for (size_t u = 0; u < UNROLL; ++u)
+            {
+                for (size_t j = 0; j < LANES<double>; ++j)
+                {
+                    result = pick(acc[u][j], result);
+                }
+            }
+        }
+        for (; i < n; ++i)
+        {
+            result = pick(mB[i], result);
+        }
+        return result;
+    }
+};
+
+#endif
@@ -0,0 +1,117 @@
+#include <iostream>
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+#include "Foo.hpp"
+#include "FooStore.hpp"
+
+// Exercise 8's filter and a few scans over ROWS foos, held as a vector<unique_ptr<foo>> (the
+// pointers shuffled the way a long-lived heap scatters them) and as a FooStore. Prints one
+// CSV row per kernel and layout with the best of RUNS runs in ms and the rate in million
+// rows per second. store_scalar passes a predicate that only takes an int, so it runs
+// element by element on the columns.
+
+using namespace std::chrono;
+
+const size_t ROWS = 2000000;
+const int RUNS = 3;
+const int THRESHOLD = 50;   // a is uniform in [0, 100), so about half the rows match
+
+using Pointers = std::vector<std::unique_ptr<foo>>;
+
+int rowA(size_t i) { return static_cast<int>((i * 2654435761u >> 7) % 100); }
+double rowB(size_t i) { return static_cast<double>((i * 40503u) % 1000) * 0.25; }
+
+Pointers makePointers(void)
+{
+    Pointers v;
+    v.reserve(ROWS);
+    for (size_t i = 0; i < ROWS; ++i)
+    {
+        v.push_back(std::make_unique<foo>(rowA(i), rowB(i), "Foo"));
+    }
+    std::shuffle(v.begin(), v.end(), std::mt19937(42));
+    return v;
+}
+
+FooStore makeStore(void)
+{
+    FooStore s;
+    s.reserve(ROWS);
+    for (size_t i = 0; i < ROWS; ++i)
+    {
+        s.emplace_back(rowA(i), rowB(i), "Foo");
+    }
+    return s;
+}
+
+// setup() builds fresh input untimed, run(input) is timed
+template <typename Setup, typename Run>
+void bench(const char *kernel, const char *layout, Setup setup, Run run)
+{
+    double best = 1e30;
+    double result = 0.0;
+    for (int r = 0; r < RUNS; ++r)
+    {
+        decltype(auto) input = setup();
+        auto t0 = steady_clock::now();
+        result = run(input);
+        best = std::min(best, duration<double, std::milli>(steady_clock::now() - t0).count());
+    }
+    std::cout << kernel << ',' << layout << ',' << best << ',' << ROWS / best / 1e3 << ',' << result << '\n';
+}
+
+int main(void)
+{
+    std::cout << "kernel,layout,best_ms,mrows_per_s,result\n";
+
+    bench("filter_a", "unique_ptr", makePointers, [](Pointers &v) {
+        v.erase(std::remove_if(v.begin(), v.end(), [](const auto &p) { return p->a < THRESHOLD; }), v.end());
+        return static_cast<double>(v.size());
+    });
+    bench("filter_a", "store", makeStore, [](FooStore &s) {
+        s.erase_if_a([](auto a) { return a < THRESHOLD; });
+        return static_cast<double>(s.size());
+    });
+    bench("filter_a", "store_scalar", makeStore, [](FooStore &s) {
+        s.erase_if_a([](int a) { return a < THRESHOLD; });
+        return static_cast<double>(s.size());
+    });
+
+    // The scans do not modify their input, so it is built once
+    Pointers ptrs = makePointers();
+    FooStore store = makeStore();
+    auto sharedPtrs = [&ptrs]() -> Pointers& { return ptrs; };
+    auto sharedStore = [&store]() -> FooStore& { return store; };
+
+    bench("count_a", "unique_ptr", sharedPtrs, [](Pointers &v) {
+        return static_cast<double>(std::count_if(v.begin(), v.end(), [](const auto &p) { return p->a < THRESHOLD; }));
+    });
+    bench("count_a", "store", sharedStore, [](FooStore &s) {
+        return static_cast<double>(s.count_if_a([](auto a) { return a < THRESHOLD; }));
+    });
+
+    bench("sum_b", "unique_ptr", sharedPtrs, [](Pointers &v) {
+        double sum = 0.0;
+        for (const auto &p : v)
+        {
+            sum += p->b;
+        }
+        return sum;
+    });
+    bench("sum_b", "store", sharedStore, [](FooStore &s) { return s.sum_b(); });
+
+    bench("max_b", "unique_ptr", sharedPtrs, [](Pointers &v) {
+        double m = v[0]->b;
+        for (const auto &p : v)
+        {
+            m = std::max(m, p->b);
+        }
+        return m;
+    });
+    bench("max_b", "store", sharedStore, [](FooStore &s) { return s.max_b(); });
+    return 0;
+}
@@ -6,34 +6,14 @@
 #include <sstream>
 #include <stdexcept>
 #include <utility>
+#include "Foo.hpp"
+#include "FooStore.hpp"
 
 // ============================================================
 // Struct definitions for all exercises
 // ============================================================
 
-struct foo {
-    int a;
-    double b;
-    std::string c;
-
-    foo(int a_value = 0, double b_value = 0.0, const std::string& c_value = "")
-        : a(a_value), b(b_value), c(c_value) {}
-
-    ~foo() {
-        std::cout << "Destroying foo\n";
-    }
-
-    void print() const {
-        std::cout << "a: " << a << ", b: " << b << ", c: \"" << c << "\"\n";
-    }
-};
-
-struct foo_deleter {
-    void operator()(foo* p) const {
-        std::cout << "foo_deleter invoked\n";
-        delete p;
-    }
-};
+// foo and foo_deleter are in Foo.hpp, FooStore.hpp holds foos column by column
 
 // ============================================================
 // Exercises
@@ -139,6 +119,21 @@ int main() {
         std::cout << "Remaining element after remove if: ";
         elem->print();
     }
+
+    // Same filter on a FooStore: a is one contiguous int column, so the predicate runs on
+    // a vector of lanes at a time and no foo is visited through a pointer
+    FooStore store;
+    for (int i = 0; i < 10; ++i)
+    {
+        store.emplace_back(i, 1.0 + i, "Foo");
+    }
+    size_t removed = store.erase_if_a([](auto a) { return a < 3; });
+    std::cout << "FooStore removed " << removed << ", " << store.size() << " left, b sum " << store.sum_b()
+              << ", min " << store.min_b() << ", max " << store.max_b() << "\n";
+    // Back to the pointer-based form, and from it
+    std::vector<std::unique_ptr<foo>> fromStore = store.to_pointers();
+    FooStore roundTrip = FooStore::from_pointers(fromStore);
+    std::cout << "Round trip kept " << roundTrip.size() << " foos, first a = " << roundTrip.a()[0] << "\n";
     // --------------------------------------------------------
     // EXERCISE 9: Exception safety with factory function
     // --------------------------------------------------------
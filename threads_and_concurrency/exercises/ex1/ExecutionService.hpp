@@ -0,0 +1,311 @@
+#ifndef EXECUTION_SERVICE_HPP
+#define EXECUTION_SERVICE_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <stop_token>
+#include <thread>
+#include <vector>
+#include "TimerWheel.hpp"
+
+// Deadline-bound calls on a fixed pool of worker threads. Every call gets a DeadlineCall
+// that resolves exactly once: with the work's result, with its exception, or with the
+// fallback when its deadline fires on the timer wheel, whichever comes first. Resolving
+// also triggers the call's stop token, so work that checks it (std::stop_token is passed
+// to it) gives up once its answer is no longer wanted, and work still queued is skipped.
+// A caller waiting on a call is released at the deadline however long the work runs.
+//
+// Hedged calls (submitHedged) start a second attempt of the same work on another worker
+// if the first has not answered within the hedge delay. The first result wins the call,
+// and resolving it stops the other attempt through the shared token. Choosing the delay
+// near the work's usual p95 hedges about 5% of calls and cuts the tail those calls form.
+
+struct CallResult
+{
+    int value;
+    bool timedOut;
+};
+
+class DeadlineCall
+{
+public:
+    std::stop_token token(void) const { return mStop.get_token(); }
+
+    // Each returns false if the call was already resolved
+    bool complete(int value) { return resolve(value, false, nullptr); }
+    bool fail(std::exception_ptr error) { return resolve(0, false, std::move(error)); }
+    bool expire(int fallback) { return resolve(fallback, true, nullptr); }
+
+    bool resolved(void) const { return mPhase.load(std::memory_order_acquire) == DONE; }
+
+    // Blocks until resolved, then returns the outcome or rethrows the work's exception
+    CallResult wait(void) const
+    {
+        uint32_t phase;
+        while ((phase = mPhase.load(std::memory_order_acquire)) != DONE)
+        {
+            mPhase.wait(phase, std::memory_order_acquire);
+        }
+        if (mError)
+        {
+            std::rethrow_exception(mError);
+        }
+        return CallResult{mValue, mTimedOut};
+    }
+
+private:
+    static constexpr uint32_t PENDING = 0;
+    static constexpr uint32_t CLAIMED = 1;   // a resolver won and is writing the outcome
+    static constexpr uint32_t DONE = 2;
+
+    std::atomic<uint32_t> mPhase{PENDING};
+    int mValue = 0;
+    bool mTimedOut = false;
+    std::exception_ptr mError;
+    std::stop_source mStop;
+
+    bool resolve(int value, bool timedOut, std::exception_ptr error)
+    {
+        uint32_t expected = PENDING;
+        if (!mPhase.compare_exchange_strong(expected, CLAIMED, std::memory_order_acq_rel))
+        {
+            return false;
+        }
+        mValue = value;
+        mTimedOut = timedOut;
+        mError = std::move(error);
+        mPhase.store(DONE, std::memory_order_release);
+        mPhase.notify_all();
+        mStop.request_stop();
+        return true;
+    }
+};
+
+struct ExecutionStats
+{
+    uint64_t completed;   // resolved by the work's result
+    uint64_t failed;      // resolved by the work's exception
+    uint64_t timedOut;    // resolved by the deadline
+    uint64_t skipped;     // already resolved when a worker picked the work up, not run
+};
+
+// Counts over hedged calls only
+struct HedgeStats
+{
+    uint64_t calls;
+    uint64_t hedged;        // calls that started a second attempt
+    uint64_t primaryWins;   // resolved by the first attempt
+    uint64_t hedgeWins;     // resolved by the second attempt
+    uint64_t timedOut;
+
+    double hedgeRate(void) const { return calls ? static_cast<double>(hedged) / calls : 0.0; }
+};
+
+class ExecutionService
+{
+public:
+    using Clock = TimerWheel::Clock;
+    using Work = std::function<int(std::stop_token)>;
+
+    explicit ExecutionService(size_t numWorkers = defaultWorkers(), Clock::duration tick = std::chrono::milliseconds(1))
+        : mTimers(tick)
+    {
+        numWorkers = std::max<size_t>(numWorkers, 1);
+        for (size_t i = 0; i < numWorkers; ++i)
+        {
+            mWorkers.emplace_back([this]() { workerLoop(); });
+        }
+    }
+
+    // Calls still pending resolve with their fallback at once; queued work is skipped
+    ~ExecutionService()
+    {
+        mTimers.stop();
+        {
+            std::lock_guard<std::mutex> lock(mMtx);
+            mStopping = true;
+        }
+        mCv.notify_all();
+        for (auto &t : mWorkers)
+        {
+            t.join();
+        }
+    }
+
+    ExecutionService(const ExecutionService&) = delete;
+    ExecutionService& operator=(const ExecutionService&) = delete;
+
+    // Queues work and arms its deadline; the returned call can be waited on or polled
+    std::shared_ptr<DeadlineCall> submit(Work work, std::chrono::milliseconds timeout, int fallback)
+    {
+        auto call = std::make_shared<DeadlineCall>();
+        post([this, call, work = std::move(work)]() { runAttempt(*call, work, nullptr); });
+        armDeadline(call, timeout, fallback, false);
+        return call;
+    }
+
+    CallResult call(Work work, std::chrono::milliseconds timeout, int fallback)
+    {
+        return submit(std::move(work), timeout, fallback)->wait();
+    }
+
+    // Like submit, and runs a second attempt if no result has arrived after hedgeDelay.
+    // work may therefore run twice, concurrently, and must tolerate that.
+    std::shared_ptr<DeadlineCall> submitHedged(Work work, std::chrono::milliseconds hedgeDelay,
+                                               std::chrono::milliseconds timeout, int fallback)
+    {
+        struct Hedged
+        {
+            DeadlineCall call;
+            Work work;
+        };
+        auto hedged = std::make_shared<Hedged>();
+        hedged->work = std::move(work);
+        std::shared_ptr<DeadlineCall> call(hedged, &hedged->call);
+        mHedgeCalls.fetch_add(1, std::memory_order_relaxed);
+        post([this, hedged]() { runAttempt(hedged->call, hedged->work, &mPrimaryWins); });
+        if (hedgeDelay < timeout)
+        {
+            mTimers.schedule(Clock::now() + hedgeDelay, [this, hedged]()
+            {
+                if (hedged->call.resolved())
+                {
+                    return;
+                }
+                mHedges.fetch_add(1, std::memory_order_relaxed);
+                post([this, hedged]() { runAttempt(hedged->call, hedged->work, &mHedgeWins); });
+            });
+        }
+        armDeadline(call, timeout, fallback, true);
+        return call;
+    }
+
+    CallResult callHedged(Work work, std::chrono::milliseconds hedgeDelay, std::chrono::milliseconds timeout,
+                          int fallback)
+    {
+        return submitHedged(std::move(work), hedgeDelay, timeout, fallback)->wait();
+    }
+
+    ExecutionStats getStats(void) const
+    {
+        return ExecutionStats{mCompleted.load(std::memory_order_relaxed), mFailed.load(std::memory_order_relaxed),
+                              mTimedOut.load(std::memory_order_relaxed), mSkipped.load(std::memory_order_relaxed)};
+    }
+
+    HedgeStats getHedgeStats(void) const
+    {
+        return HedgeStats{mHedgeCalls.load(std::memory_order_relaxed), mHedges.load(std::memory_order_relaxed),
+                          mPrimaryWins.load(std::memory_order_relaxed), mHedgeWins.load(std::memory_order_relaxed),
+                          mHedgeTimedOut.load(std::memory_order_relaxed)};
+    }
+
+    static size_t defaultWorkers(void)
+    {
+        return std::max(4u, std::thread::hardware_concurrency());
+    }
+
+private:
+    TimerWheel mTimers;
+    std::vector<std::thread> mWorkers;
+    std::deque<std::function<void()>> mQueue;
+    bool mStopping = false;
+    std::mutex mMtx;
+    std::condition_variable mCv;
+    std::atomic<uint64_t> mCompleted{0};
+    std::atomic<uint64_t> mFailed{0};
+    std::atomic<uint64_t> mTimedOut{0};
+    std::atomic<uint64_t> mSkipped{0};
+    std::atomic<uint64_t> mHedgeCalls{0};
+    std::atomic<uint64_t> mHedges{0};
+    std::atomic<uint64_t> mPrimaryWins{0};
+    std::atomic<uint64_t> mHedgeWins{0};
+    std::atomic<uint64_t> mHedgeTimedOut{0};
+
+    void post(std::function<void()> job)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mMtx);
+            if (mStopping)
+            {
+                throw std::runtime_error("Attempting to submit when ExecutionService is shutting down");
+            }
+            mQueue.push_back(std::move(job));
+        }
+        mCv.notify_one();
+    }
+
+    void armDeadline(const std::shared_ptr<DeadlineCall> &call, std::chrono::milliseconds timeout, int fallback,
+                     bool hedged)
+    {
+        mTimers.schedule(Clock::now() + timeout, [this, call, fallback, hedged]()
+        {
+            if (call->expire(fallback))
+            {
+                mTimedOut.fetch_add(1, std::memory_order_relaxed);
+                if (hedged)
+                {
+                    mHedgeTimedOut.fetch_add(1, std::memory_order_relaxed);
+                }
+            }
+        });
+    }
+
+    // wins, if given, counts the calls this attempt resolved with a result
+    void runAttempt(DeadlineCall &call, const Work &work, std::atomic<uint64_t> *wins)
+    {
+        if (call.resolved())
+        {
+            mSkipped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        try
+        {
+            if (call.complete(work(call.token())))
+            {
+                mCompleted.fetch_add(1, std::memory_order_relaxed);
+                if (wins)
+                {
+                    wins->fetch_add(1, std::memory_order_relaxed);
+                }
+            }
+        }
+        catch (...)
+        {
+            if (call.fail(std::current_exception()))
+            {
+                mFailed.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // Runs until shutdown has been requested and the queue is empty
+    void workerLoop(void)
+    {
+        std::unique_lock<std::mutex> lock(mMtx);
+        while (true)
+        {
+            mCv.wait(lock, [this]() { return mStopping || !mQueue.empty(); });
+            if (mQueue.empty())
+            {
+                return;
+            }
+            std::function<void()> job = std::move(mQueue.front());
+            mQueue.pop_front();
+            lock.unlock();
+            job();
+            job = nullptr;
+            lock.lock();
+        }
+    }
+};
+
+#endif
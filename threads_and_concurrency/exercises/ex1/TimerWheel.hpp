@@ -0,0 +1,167 @@
+#ifndef TIMER_WHEEL_HPP
+#define TIMER_WHEEL_HPP
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// Hashed timer wheel: a ring of buckets, one per tick, turned by a single thread. Scheduling
+// a callback is O(1), a push into the bucket of its expiry tick; each tick the thread only
+// looks at one bucket, firing the entries that are due and leaving those a full turn or
+// more away. Callbacks never fire early and at most one tick late. The thread sleeps while
+// the wheel is empty.
+//
+// There is no cancel: a callback whose work is already done is expected to find that out
+// and do nothing, which is cheaper than unlinking it.
+
+class TimerWheel
+{
+public:
+    using Clock = std::chrono::steady_clock;
+    using Callback = std::function<void()>;
+
+    explicit TimerWheel(Clock::duration tick = std::chrono::milliseconds(1), size_t slots = 512)
+        : mTick(tick), mEpoch(Clock::now()), mSlots(slots)
+    {
+        mThread = std::thread([this]() { turn(); });
+    }
+
+    ~TimerWheel() { stop(); }
+
+    TimerWheel(const TimerWheel&) = delete;
+    TimerWheel& operator=(const TimerWheel&) = delete;
+
+    // After stop() callbacks run straight away on the calling thread
+    void schedule(Clock::time_point deadline, Callback callback)
+    {
+        std::unique_lock<std::mutex> lock(mMtx);
+        if (mStop)
+        {
+            lock.unlock();
+            callback();
+            return;
+        }
+        const uint64_t expiry = std::max(tickAtOrAfter(deadline), mCursor + 1);
+        mSlots[expiry % mSlots.size()].push_back(Entry{expiry, std::move(callback)});
+        if (mCount++ == 0)
+        {
+            mCv.notify_one();
+        }
+    }
+
+    // Fires every pending callback now, whatever its deadline, and stops the thread
+    void stop(void)
+    {
+        std::vector<Entry> pending;
+        {
+            std::unique_lock<std::mutex> lock(mMtx);
+            if (mStop)
+            {
+                return;
+            }
+            mStop = true;
+            for (auto &slot : mSlots)
+            {
+                std::move(slot.begin(), slot.end(), std::back_inserter(pending));
+                slot.clear();
+            }
+            mCount = 0;
+        }
+        mCv.notify_all();
+        mThread.join();
+        for (Entry &e : pending)
+        {
+            e.callback();
+        }
+    }
+
+    size_t pending(void) const
+    {
+        std::lock_guard<std::mutex> lock(mMtx);
+        return mCount;
+    }
+
+private:
+    struct Entry
+    {
+        uint64_t expiry;
+        Callback callback;
+    };
+
+    const Clock::duration mTick;
+    const Clock::time_point mEpoch;
+    std::vector<std::vector<Entry>> mSlots;
+    uint64_t mCursor = 0;   // last tick processed
+    size_t mCount = 0;
+    bool mStop = false;
+    mutable std::mutex mMtx;
+    std::condition_variable mCv;
+    std::thread mThread;
+
+    uint64_t tickOf(Clock::time_point t) const
+    {
+        return static_cast<uint64_t>((t - mEpoch) / mTick);
+    }
+
+    uint64_t tickAtOrAfter(Clock::time_point t) const
+    {
+        if (t <= mEpoch)
+        {
+            return 0;
+        }
+        return static_cast<uint64_t>((t - mEpoch + mTick - Clock::duration(1)) / mTick);
+    }
+
+    void turn(void)
+    {
+        std::vector<Callback> due;
+        std::unique_lock<std::mutex> lock(mMtx);
+        while (!mStop)
+        {
+            if (mCount == 0)
+            {
+                mCv.wait(lock, [this]() { return mStop || mCount > 0; });
+                continue;
+            }
+            const uint64_t now = tickOf(Clock::now());
+            if (now <= mCursor)
+            {
+                mCv.wait_until(lock, mEpoch + mTick * static_cast<Clock::rep>(mCursor + 1));
+                continue;
+            }
+            // After a stall visit each bucket once rather than every missed tick
+            const uint64_t from = std::max(mCursor + 1, now >= mSlots.size() ? now - mSlots.size() + 1 : 0);
+            for (uint64_t t = from; t <= now; ++t)
+            {
+                auto &slot = mSlots[t % mSlots.size()];
+                auto keep = std::partition(slot.begin(), slot.end(), [now](const Entry &e) { return e.expiry > now; });
+                for (auto it = keep; it != slot.end(); ++it)
+                {
+                    due.push_back(std::move(it->callback));
+                }
+                mCount -= static_cast<size_t>(slot.end() - keep);
+                slot.erase(keep, slot.end());
+            }
+            mCursor = now;
+            if (!due.empty())
+            {
+                lock.unlock();
+                for (auto &callback : due)
+                {
+                    callback();
+                }
+                due.clear();
+                lock.lock();
+            }
+        }
+    }
+};
+
+#endif
@@ -0,0 +1,96 @@
+#include <iostream>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+#include "ExecutionService.hpp"
+
+// Tail latency of a flaky computation with and without hedging. Each attempt usually takes
+// 1-3 ms but one in twenty stalls for 30-60 ms, independently per attempt, the way a call to
+// a busy replica does. CLIENTS threads each make CALLS calls; hedged runs start a second
+// attempt after the hedge delay. Prints latency percentiles, the hedge rate, which attempt
+// won, and attempts actually run per call (the extra load hedging costs).
+
+using namespace std::chrono;
+
+const size_t CLIENTS = 4;
+const size_t CALLS = 300;
+const auto TIMEOUT = milliseconds(100);
+const int FALLBACK = -1;
+const milliseconds HEDGE_DELAYS[] = {milliseconds(4), milliseconds(8)};
+
+std::atomic<unsigned> attemptSeq{0};
+std::atomic<uint64_t> attemptsRun{0};
+
+int flakyWork(std::stop_token st)
+{
+    attemptsRun.fetch_add(1, std::memory_order_relaxed);
+    unsigned x = attemptSeq.fetch_add(1, std::memory_order_relaxed) * 2654435761u;
+    x ^= x >> 15;
+    const int workMs = (x % 20 == 0) ? 30 + static_cast<int>((x >> 8) % 31) : 1 + static_cast<int>((x >> 8) % 3);
+    for (int ms = 0; ms < workMs; ++ms)
+    {
+        if (st.stop_requested())
+        {
+            return FALLBACK;
+        }
+        std::this_thread::sleep_for(milliseconds(1));
+    }
+    return workMs;
+}
+
+void runBenchmark(const std::string &name, std::optional<milliseconds> hedgeDelay)
+{
+    ExecutionService service(CLIENTS * 3);
+    attemptSeq = 0;
+    attemptsRun = 0;
+    std::vector<std::vector<uint64_t>> latencies(CLIENTS);
+    std::vector<std::thread> clients;
+    for (size_t c = 0; c < CLIENTS; ++c)
+    {
+        clients.emplace_back([&, c]() {
+            for (size_t i = 0; i < CALLS; ++i)
+            {
+                auto t0 = steady_clock::now();
+                if (hedgeDelay)
+                {
+                    service.callHedged(flakyWork, *hedgeDelay, TIMEOUT, FALLBACK);
+                }
+                else
+                {
+                    service.call(flakyWork, TIMEOUT, FALLBACK);
+                }
+                latencies[c].push_back(duration_cast<microseconds>(steady_clock::now() - t0).count());
+            }
+        });
+    }
+    for (auto &t : clients)
+    {
+        t.join();
+    }
+
+    std::vector<uint64_t> all;
+    for (auto &l : latencies)
+    {
+        all.insert(all.end(), l.begin(), l.end());
+    }
+    std::sort(all.begin(), all.end());
+    HedgeStats h = service.getHedgeStats();
+    std::cout << name << ',' << all[all.size() / 2] << ',' << all[all.size() * 9 / 10] << ','
+              << all[all.size() * 99 / 100] << ',' << all.back() << ',' << h.hedgeRate() << ',' << h.primaryWins << ','
+              << h.hedgeWins << ',' << static_cast<double>(attemptsRun) / all.size() << '\n';
+}
+
+int main(void)
+{
+    std::cout << "mode,p50_us,p90_us,p99_us,max_us,hedge_rate,primary_wins,hedge_wins,attempts_per_call\n";
+    runBenchmark("plain", std::nullopt);
+    for (milliseconds delay : HEDGE_DELAYS)
+    {
+        runBenchmark("hedged_" + std::to_string(delay.count()) + "ms", delay);
+    }
+    return 0;
+}
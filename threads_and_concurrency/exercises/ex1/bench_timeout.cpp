@@ -0,0 +1,103 @@
+#include <iostream>
+#include <algorithm>
+#include <chrono>
+#include <future>
+#include <string>
+#include <thread>
+#include <vector>
+#include "ExecutionService.hpp"
+
+// Latency of deadline-bound calls: CLIENTS threads each make CALLS calls whose work takes
+// 0-20 ms (about half of them past the TIMEOUT). The std::async baseline starts a thread
+// per call and its future's destructor waits out the work on timeout; the service returns
+// the fallback at the deadline and the work, which polls its stop token, gives up.
+
+using namespace std::chrono;
+
+const size_t CLIENTS = 4;
+const size_t CALLS = 250;
+const auto TIMEOUT = milliseconds(10);
+const int MAX_WORK_MS = 20;
+const int FALLBACK = -1;
+
+int simulatedWork(int workMs, std::stop_token st)
+{
+    for (int ms = 0; ms < workMs; ++ms)
+    {
+        if (st.stop_requested())
+        {
+            return FALLBACK;
+        }
+        std::this_thread::sleep_for(milliseconds(1));
+    }
+    return workMs;
+}
+
+int viaAsync(int workMs)
+{
+    std::future<int> f = std::async(std::launch::async, [workMs]() { return simulatedWork(workMs, {}); });
+    if (f.wait_for(TIMEOUT) == std::future_status::timeout)
+    {
+        return FALLBACK;   // f's destructor blocks here until the work is done
+    }
+    return f.get();
+}
+
+template <typename Call>
+void runBenchmark(const std::string &name, Call call)
+{
+    std::vector<std::vector<uint64_t>> latencies(CLIENTS);
+    std::vector<size_t> fallbacks(CLIENTS, 0);
+    auto start = steady_clock::now();
+    std::vector<std::thread> clients;
+    for (size_t c = 0; c < CLIENTS; ++c)
+    {
+        clients.emplace_back([&, c]() {
+            unsigned x = static_cast<unsigned>(c) * 7919u + 1u;
+            for (size_t i = 0; i < CALLS; ++i)
+            {
+                x = x * 1664525u + 1013904223u;
+                const int workMs = static_cast<int>((x >> 16) % (MAX_WORK_MS + 1));
+                auto t0 = steady_clock::now();
+                if (call(workMs) == FALLBACK)
+                {
+                    ++fallbacks[c];
+                }
+                latencies[c].push_back(duration_cast<microseconds>(steady_clock::now() - t0).count());
+            }
+        });
+    }
+    for (auto &t : clients)
+    {
+        t.join();
+    }
+    double secs = duration<double>(steady_clock::now() - start).count();
+
+    std::vector<uint64_t> all;
+    size_t fallbackCount = 0;
+    for (size_t c = 0; c < CLIENTS; ++c)
+    {
+        all.insert(all.end(), latencies[c].begin(), latencies[c].end());
+        fallbackCount += fallbacks[c];
+    }
+    std::sort(all.begin(), all.end());
+    std::cout << name << ',' << all.size() << ',' << fallbackCount << ',' << static_cast<uint64_t>(all.size() / secs)
+              << ',' << all[all.size() / 2] << ',' << all[all.size() * 99 / 100] << ',' << all.back() << '\n';
+}
+
+int main(void)
+{
+    std::cout << "mode,calls,fallbacks,calls_per_s,p50_us,p99_us,max_us\n";
+    runBenchmark("std_async", viaAsync);
+    {
+        ExecutionService service(CLIENTS * 2);
+        runBenchmark("execution_service", [&service](int workMs) {
+            return service.call([workMs](std::stop_token st) { return simulatedWork(workMs, st); }, TIMEOUT, FALLBACK)
+                .value;
+        });
+        ExecutionStats s = service.getStats();
+        std::cout << "# service: completed " << s.completed << ", timed out " << s.timedOut << ", skipped "
+                  << s.skipped << '\n';
+    }
+    return 0;
+}
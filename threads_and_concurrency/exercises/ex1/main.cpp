@@ -1,12 +1,19 @@
 #include <iostream>
 #include <thread>
 #include <future>
+#include <atomic>
+#include "ExecutionService.hpp"
 
 // Write int compute_with_timeout(std::function<int()> work, std::chrono::milliseconds dflt, int fallback)
 // that launches work with std::async. If it doesn’t finish within dflt, return fallback;
 // otherwise return the result. (Don’t block forever.)
+//
+// The std::async version starts a thread per call, and on timeout the future's destructor
+// still waits for the work to finish, so the timeout does not bound the call. It is kept
+// as compute_with_timeout_async for comparison; compute_with_timeout now runs on a shared
+// ExecutionService, returns at the deadline and asks the work to stop.
 
-int compute_with_timeout(std::function<int()> work, std::chrono::milliseconds dflt, int fallback)
+int compute_with_timeout_async(std::function<int()> work, std::chrono::milliseconds dflt, int fallback)
 {
     std::future<int> f = std::async(std::launch::async, std::move(work));
     auto status = f.wait_for(dflt);
@@ -20,7 +27,32 @@ int compute_with_timeout(std::function<int()> work, std::chrono::milliseconds df
         std::cout << "No timeout, future data ready\n";
         return f.get();
     }
-    
+
+}
+
+ExecutionService& executionService(void)
+{
+    static ExecutionService service;
+    return service;
+}
+
+// Work that checks the token can stop early once the call has timed out
+int compute_with_timeout(std::function<int(std::stop_token)> work, std::chrono::milliseconds dflt, int fallback)
+{
+    return executionService().call(std::move(work), dflt, fallback).value;
+}
+
+int compute_with_timeout(std::function<int()> work, std::chrono::milliseconds dflt, int fallback)
+{
+    return compute_with_timeout([work = std::move(work)](std::stop_token) { return work(); }, dflt, fallback);
+}
+
+// Hedged: a second copy of work starts if the first has not answered within hedge; the
+// first result is returned and the other copy is asked to stop
+int compute_with_timeout_hedged(std::function<int(std::stop_token)> work, std::chrono::milliseconds hedge,
+                                std::chrono::milliseconds dflt, int fallback)
+{
+    return executionService().callHedged(std::move(work), hedge, dflt, fallback).value;
 }
 
 int main(void)
@@ -29,9 +61,53 @@ int main(void)
     const int SIMULATED_WORK_TIME_MS = 100;
     const int FUTURE_WAIT_TIME_MS = 10;
 
-    int val = compute_with_timeout([](){ std::this_thread::sleep_for(std::chrono::milliseconds(SIMULATED_WORK_TIME));
-                                         return 10; },
+    auto start = std::chrono::steady_clock::now();
+    int val = compute_with_timeout_async([=](){ std::this_thread::sleep_for(std::chrono::milliseconds(SIMULATED_WORK_TIME_MS));
+                                               return 10; },
                                          std::chrono::milliseconds(FUTURE_WAIT_TIME_MS), 42);
-    std::cout << "Returned val: " << val << "\n";
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+    std::cout << "Returned val: " << val << " after " << elapsed.count() << " ms (std::async)\n";
+
+    // Same work, polling the token in 1 ms steps so it stops soon after the deadline
+    start = std::chrono::steady_clock::now();
+    val = compute_with_timeout([=](std::stop_token st)
+                               {
+                                   for (int ms = 0; ms < SIMULATED_WORK_TIME_MS; ++ms)
+                                   {
+                                       if (st.stop_requested())
+                                       {
+                                           std::cout << "Work cancelled after " << ms << " ms\n";
+                                           return -1;
+                                       }
+                                       std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                                   }
+                                   return 10;
+                               },
+                               std::chrono::milliseconds(FUTURE_WAIT_TIME_MS), 42);
+    elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+    std::cout << "Returned val: " << val << " after " << elapsed.count() << " ms (ExecutionService)\n";
+
+    val = compute_with_timeout([]() { return 10; }, std::chrono::milliseconds(FUTURE_WAIT_TIME_MS), 42);
+    std::cout << "Returned val: " << val << " (work finished in time)\n";
+
+    // First attempt is slow, the hedge started after 5 ms answers quickly
+    std::atomic<int> attempts{0};
+    val = compute_with_timeout_hedged([&attempts](std::stop_token st)
+                                      {
+                                          const int workMs = (attempts++ == 0) ? 50 : 2;
+                                          for (int ms = 0; ms < workMs && !st.stop_requested(); ++ms)
+                                          {
+                                              std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                                          }
+                                          return workMs;
+                                      },
+                                      std::chrono::milliseconds(5), std::chrono::milliseconds(100), 42);
+    std::cout << "Returned val: " << val << " (hedged, answered by the second attempt)\n";
 
+    ExecutionStats stats = executionService().getStats();
+    std::cout << "completed " << stats.completed << ", timed out " << stats.timedOut << ", skipped "
+              << stats.skipped << "\n";
+    HedgeStats hedges = executionService().getHedgeStats();
+    std::cout << "hedged calls " << hedges.calls << ", hedge rate " << hedges.hedgeRate() << ", primary wins "
+              << hedges.primaryWins << ", hedge wins " << hedges.hedgeWins << "\n";
 }
@@ -0,0 +1,201 @@
+#ifndef ONE_SHOT_HPP
+#define ONE_SHOT_HPP
+
+#include <atomic>
+#include <cassert>
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+// One-shot channel: a single value or exception handed from one producer to one consumer,
+// the job std::promise/std::future do without their heap-allocated shared state, mutex
+// and condition variable. The channel is the state itself, so it can live on the stack,
+// inside another object, or come from a OneShotPool; it must outlive both ends' use of it.
+//
+// Completing it is one atomic exchange, plus a futex wake only when the consumer is
+// already asleep. The consumer can block in get() or poll with try_get().
+//
+// Contract: set_value/set_exception are called at most once, and get()/try_get() take the
+// result once. After complete, the producer must not touch the channel again.
+
+template <typename T>
+class OneShot
+{
+public:
+    static_assert(!std::is_reference_v<T> && !std::is_void_v<T>, "OneShot carries a value");
+
+    OneShot() = default;
+    OneShot(const OneShot&) = delete;
+    OneShot& operator=(const OneShot&) = delete;
+    ~OneShot() { destroyValue(); }
+
+    template <typename... Args>
+    void set_value(Args&&... args)
+    {
+        new (mStorage) T(std::forward<Args>(args)...);
+        complete(VALUE);
+    }
+
+    void set_exception(std::exception_ptr error)
+    {
+        mError = std::move(error);
+        complete(ERROR);
+    }
+
+    bool ready(void) const
+    {
+        const uint32_t s = mState.load(std::memory_order_acquire);
+        return s == VALUE || s == ERROR;
+    }
+
+    void wait(void)
+    {
+        uint32_t seen = mState.load(std::memory_order_acquire);
+        while (seen == EMPTY || seen == WAITING)
+        {
+            if (seen == EMPTY && !mState.compare_exchange_weak(seen, WAITING, std::memory_order_acquire))
+            {
+                continue;
+            }
+            ::syscall(SYS_futex, reinterpret_cast<uint32_t*>(&mState), FUTEX_WAIT_PRIVATE, WAITING, nullptr, nullptr, 0);
+            seen = mState.load(std::memory_order_acquire);
+        }
+    }
+
+    // Blocks until the producer is done, then returns the value or rethrows its exception
+    T get(void)
+    {
+        wait();
+        return take();
+    }
+
+    // Never blocks: nullopt while the producer has not finished
+    std::optional<T> try_get(void)
+    {
+        if (!ready())
+        {
+            return std::nullopt;
+        }
+        return take();
+    }
+
+    // Makes a finished channel usable again; only once neither end is using it
+    void reset(void)
+    {
+        destroyValue();
+        mError = nullptr;
+        mState.store(EMPTY, std::memory_order_relaxed);
+    }
+
+private:
+    static constexpr uint32_t EMPTY = 0;
+    static constexpr uint32_t WAITING = 1;    // consumer asleep, or about to be
+    static constexpr uint32_t VALUE = 2;
+    static constexpr uint32_t ERROR = 3;
+    static constexpr uint32_t TAKEN = 4;      // value moved out by the consumer
+
+    std::atomic<uint32_t> mState{EMPTY};
+    alignas(T) std::byte mStorage[sizeof(T)];
+    std::exception_ptr mError;
+
+    T* value(void) { return std::launder(reinterpret_cast<T*>(mStorage)); }
+
+    void complete(uint32_t state)
+    {
+        const uint32_t prev = mState.exchange(state, std::memory_order_acq_rel);
+        assert(prev == EMPTY || prev == WAITING);
+        if (prev == WAITING)
+        {
+            // The consumer may already have seen the state and reused or freed the channel;
+            // the wake only uses the address, so at worst a later waiter wakes spuriously
+            ::syscall(SYS_futex, reinterpret_cast<uint32_t*>(&mState), FUTEX_WAKE_PRIVATE, 1, nullptr, nullptr, 0);
+        }
+    }
+
+    T take(void)
+    {
+        if (mState.load(std::memory_order_relaxed) == ERROR)
+        {
+            std::rethrow_exception(mError);
+        }
+        assert(mState.load(std::memory_order_relaxed) == VALUE);
+        T result = std::move(*value());
+        value()->~T();
+        mState.store(TAKEN, std::memory_order_relaxed);
+        return result;
+    }
+
+    void destroyValue(void)
+    {
+        if (mState.load(std::memory_order_acquire) == VALUE)
+        {
+            value()->~T();
+            mState.store(TAKEN, std::memory_order_relaxed);
+        }
+    }
+};
+
+// Recycles OneShot channels so a hand-off in steady state allocates nothing. acquire()
+// returns a handle that puts the channel back, reset, when it goes out of scope.
+template <typename T>
+class OneShotPool
+{
+public:
+    struct Release
+    {
+        OneShotPool *pool;
+        void operator()(OneShot<T> *channel) const { pool->release(channel); }
+    };
+    using Handle = std::unique_ptr<OneShot<T>, Release>;
+
+    OneShotPool() = default;
+    OneShotPool(const OneShotPool&) = delete;
+    OneShotPool& operator=(const OneShotPool&) = delete;
+
+    // Every handle must be gone before the pool is destroyed
+    ~OneShotPool()
+    {
+        for (OneShot<T> *c : mFree)
+        {
+            delete c;
+        }
+    }
+
+    Handle acquire(void)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mMtx);
+            if (!mFree.empty())
+            {
+                OneShot<T> *c = mFree.back();
+                mFree.pop_back();
+                return Handle(c, Release{this});
+            }
+        }
+        return Handle(new OneShot<T>, Release{this});
+    }
+
+private:
+    std::mutex mMtx;
+    std::vector<OneShot<T>*> mFree;
+
+    void release(OneShot<T> *channel)
+    {
+        channel->reset();
+        std::lock_guard<std::mutex> lock(mMtx);
+        mFree.push_back(channel);
+    }
+};
+
+#endif
@@ -0,0 +1,206 @@
+#include <iostream>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include "OneShot.hpp"
+
+// Cost of a single value-or-exception hand-off, std::promise/std::future against OneShot
+// (on the stack and from a OneShotPool), on the success and the exception path.
+//   same_thread:  create, complete and consume on one thread, the bare channel overhead
+//   cross_thread: a producer thread completes the channel the consumer is blocked on;
+//                 both variants pass the request over the same mailbox
+// The exception is built once and reused so rethrowing it is the only exception cost.
+// Each case reports the best of RUNS runs.
+
+using namespace std::chrono;
+
+const int SAME_THREAD_OPS = 1000000;
+const int CROSS_THREAD_OPS = 50000;
+const int RUNS = 3;
+
+const std::exception_ptr ERROR = std::make_exception_ptr(std::runtime_error("boom"));
+
+struct PromiseChannel
+{
+    std::promise<int> p;
+    std::future<int> f = p.get_future();
+
+    static void complete(std::promise<int> &p, int i, bool fail)
+    {
+        if (fail)
+        {
+            p.set_exception(ERROR);
+        }
+        else
+        {
+            p.set_value(i);
+        }
+    }
+};
+
+void complete(OneShot<int> &ch, int i, bool fail)
+{
+    if (fail)
+    {
+        ch.set_exception(ERROR);
+    }
+    else
+    {
+        ch.set_value(i);
+    }
+}
+
+// Returns the value, or -1 if it came back as an exception
+template <typename Get>
+int consume(Get get)
+{
+    try
+    {
+        return get();
+    }
+    catch (const std::exception&)
+    {
+        return -1;
+    }
+}
+
+// Hands requests from the benchmark thread to one producer thread
+class Mailbox
+{
+public:
+    void post(void *request)
+    {
+        mSlot.store(request, std::memory_order_release);
+        mSlot.notify_one();
+    }
+
+    void *take(void)
+    {
+        void *request;
+        while (!(request = mSlot.exchange(nullptr, std::memory_order_acquire)))
+        {
+            mSlot.wait(nullptr, std::memory_order_acquire);
+        }
+        return request;
+    }
+
+private:
+    std::atomic<void*> mSlot{nullptr};
+};
+
+template <typename Body>
+double bestNsPerOp(int ops, Body body)
+{
+    double best = 1e30;
+    for (int run = 0; run < RUNS; ++run)
+    {
+        long long sum = 0;
+        auto t0 = steady_clock::now();
+        for (int i = 0; i < ops; ++i)
+        {
+            sum += body(i);
+        }
+        double ns = duration<double, std::nano>(steady_clock::now() - t0).count() / ops;
+        if (sum == 42)
+        {
+            std::cout << "";   // keeps sum alive
+        }
+        best = std::min(best, ns);
+    }
+    return best;
+}
+
+void sameThread(bool fail)
+{
+    const char *path = fail ? "exception" : "value";
+    double promise = bestNsPerOp(SAME_THREAD_OPS, [fail](int i) {
+        PromiseChannel ch;
+        PromiseChannel::complete(ch.p, i, fail);
+        return consume([&]() { return ch.f.get(); });
+    });
+    double inlineShot = bestNsPerOp(SAME_THREAD_OPS, [fail](int i) {
+        OneShot<int> ch;
+        complete(ch, i, fail);
+        return consume([&]() { return ch.get(); });
+    });
+    OneShotPool<int> pool;
+    double pooledShot = bestNsPerOp(SAME_THREAD_OPS, [fail, &pool](int i) {
+        auto ch = pool.acquire();
+        complete(*ch, i, fail);
+        return consume([&]() { return ch->get(); });
+    });
+    std::cout << "same_thread," << path << ",std_promise," << promise << '\n';
+    std::cout << "same_thread," << path << ",oneshot_inline," << inlineShot << '\n';
+    std::cout << "same_thread," << path << ",oneshot_pooled," << pooledShot << '\n';
+}
+
+void crossThread(bool fail)
+{
+    const char *path = fail ? "exception" : "value";
+    static int stop;
+
+    // The producer moves the promise out before completing it, as a thread handed a promise does
+    double promise;
+    {
+        Mailbox box;
+        std::thread producer([&box, fail]() {
+            for (int i = 0;; ++i)
+            {
+                void *request = box.take();
+                if (request == &stop)
+                {
+                    return;
+                }
+                std::promise<int> p(std::move(*static_cast<std::promise<int>*>(request)));
+                PromiseChannel::complete(p, i, fail);
+            }
+        });
+        promise = bestNsPerOp(CROSS_THREAD_OPS, [&box](int) {
+            std::promise<int> p;
+            std::future<int> f = p.get_future();
+            box.post(&p);
+            return consume([&]() { return f.get(); });
+        });
+        box.post(&stop);
+        producer.join();
+    }
+
+    double inlineShot;
+    {
+        Mailbox box;
+        std::thread producer([&box, fail]() {
+            for (int i = 0;; ++i)
+            {
+                void *request = box.take();
+                if (request == &stop)
+                {
+                    return;
+                }
+                complete(*static_cast<OneShot<int>*>(request), i, fail);
+            }
+        });
+        inlineShot = bestNsPerOp(CROSS_THREAD_OPS, [&box](int) {
+            OneShot<int> ch;
+            box.post(&ch);
+            return consume([&]() { return ch.get(); });
+        });
+        box.post(&stop);
+        producer.join();
+    }
+    std::cout << "cross_thread," << path << ",std_promise," << promise << '\n';
+    std::cout << "cross_thread," << path << ",oneshot_inline," << inlineShot << '\n';
+}
+
+int main(void)
+{
+    std::cout << "mode,path,channel,ns_per_op\n";
+    sameThread(false);
+    sameThread(true);
+    crossThread(false);
+    crossThread(true);
+    return 0;
+}
@@ -3,6 +3,7 @@
 #include <future>
 #include <string>
 #include <iostream>
+#include "OneShot.hpp"
 
 void task1(void)
 {
@@ -28,6 +29,26 @@ void task2(std::promise<std::string> &p, bool success)
     }
 }
 
+// task2 over a OneShot channel: same value-or-exception hand-off, no shared-state allocation
+void task3(OneShot<std::string> &ch, bool success)
+{
+    try
+    {
+        if (success)
+        {
+            ch.set_value("hello");
+        }
+        else
+        {
+            throw std::runtime_error("Boom");
+        }
+    }
+    catch (const std::exception& e)
+    {
+        ch.set_exception(std::current_exception());
+    }
+}
+
 int main() {
     // Part A:
     //   Start a background execution agent that processes input guaranteed to fail.
@@ -43,7 +64,7 @@ int main() {
     //   Explain when abnormal termination may occur in a background agent and how to avoid it.
 
     // A use try-catch in main from exception thrown by thread. (Won't see exception gracefully)
-    // Run either A, B, or B2
+    // Run either A, B, B2 or B3: uncomment one and leave the others commented out
     /*std::promise<std::string> p;
     std::future<std::string> f = p.get_future();
     std::thread t(task1);
@@ -84,5 +105,20 @@ int main() {
         std::cout << e.what() << "\n";
     }
     t.join();
+
+    // B3
+    // Same as B2 over a OneShot living on this stack frame; try_get polls without blocking
+    /*OneShot<std::string> ch;
+    std::thread t3(task3, std::ref(ch), true);
+    try
+    {
+        std::optional<std::string> early = ch.try_get();
+        std::cout << (early ? *early : ch.get()) << "\n";
+    }
+    catch (const std::exception& e)
+    {
+        std::cout << e.what() << "\n";
+    }
+    t3.join();*/
     return 0;
 }
@@ -0,0 +1,316 @@
+#ifndef CO_TASK_HPP
+#define CO_TASK_HPP
+
+#include <chrono>
+#include <coroutine>
+#include <exception>
+#include <optional>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include "taskQueue.hpp"
+
+// C++20 coroutines on top of taskQueue. A coroutine returning coro::task<T> starts when it
+// is awaited and can
+//
+//   co_await coro::schedule(pool)          continue on one of the pool's workers
+//   co_await coro::sleep_for(pool, 10ms)   continue on the pool once 10 ms have passed
+//   T v = co_await otherTask()             run another task and take its result
+//
+// A suspended coroutine holds no thread, so thousands of them waiting on timers cost only
+// their frames. coro::spawn(pool, t) starts a task from ordinary code and returns a
+// TaskFuture for its result, which can be waited on or given continuations.
+//
+// If the pool shuts down non-gracefully while a coroutine waits for a worker or a timer,
+// the coroutine is resumed anyway and the co_await throws std::runtime_error, so it unwinds
+// and its future reports the error instead of hanging.
+// The name lives in namespace coro because the exercise's main.cpp already has a task().
+
+namespace coro
+{
+
+template <typename T = void>
+class task;
+
+namespace detail
+{
+
+struct PromiseBase
+{
+    std::coroutine_handle<> mContinuation;
+    std::exception_ptr mError;
+
+    // Lazy: the body only runs once someone awaits the task
+    std::suspend_always initial_suspend(void) noexcept { return {}; }
+
+    struct FinalAwaiter
+    {
+        bool await_ready(void) noexcept { return false; }
+
+        // Symmetric transfer back to the awaiting coroutine, so long chains of tasks
+        // completing synchronously do not grow the stack
+        template <typename Promise>
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> h) noexcept
+        {
+            if (auto next = h.promise().mContinuation)
+            {
+                return next;
+            }
+            return std::noop_coroutine();
+        }
+
+        void await_resume(void) noexcept {}
+    };
+
+    FinalAwaiter final_suspend(void) noexcept { return {}; }
+
+    void unhandled_exception(void) { mError = std::current_exception(); }
+
+    void rethrowIfFailed(void)
+    {
+        if (mError)
+        {
+            std::rethrow_exception(mError);
+        }
+    }
+};
+
+template <typename T>
+struct Promise : PromiseBase
+{
+    std::optional<T> mValue;
+
+    task<T> get_return_object(void);
+
+    template <typename V>
+    void return_value(V &&v)
+    {
+        mValue.emplace(std::forward<V>(v));
+    }
+
+    T result(void)
+    {
+        rethrowIfFailed();
+        return std::move(*mValue);
+    }
+};
+
+template <>
+struct Promise<void> : PromiseBase
+{
+    task<void> get_return_object(void);
+
+    void return_void(void) {}
+
+    void result(void) { rethrowIfFailed(); }
+};
+
+// The queued step that resumes a coroutine. One dropped unrun by a non-graceful shutdown
+// still resumes it, flagged as cancelled, so the coroutine can unwind.
+class Resume
+{
+public:
+    Resume(std::coroutine_handle<> h, bool *cancelled) : mHandle(h), mCancelled(cancelled) {}
+    Resume(Resume &&other) noexcept
+        : mHandle(std::exchange(other.mHandle, nullptr)), mCancelled(other.mCancelled) {}
+    Resume(const Resume&) = delete;
+    Resume& operator=(const Resume&) = delete;
+    Resume& operator=(Resume&&) = delete;
+
+    ~Resume()
+    {
+        if (mHandle)
+        {
+            *mCancelled = true;
+            std::exchange(mHandle, nullptr).resume();
+        }
+    }
+
+    void operator()() { std::exchange(mHandle, nullptr).resume(); }
+
+private:
+    std::coroutine_handle<> mHandle;
+    bool *mCancelled;
+};
+
+// Started eagerly by spawn; fulfils the state exactly once and then frees itself
+struct Detached
+{
+    struct promise_type
+    {
+        Detached get_return_object(void) { return {}; }
+        std::suspend_never initial_suspend(void) noexcept { return {}; }
+        std::suspend_never final_suspend(void) noexcept { return {}; }
+        void return_void(void) {}
+        void unhandled_exception(void) { std::terminate(); }
+    };
+};
+
+} // namespace detail
+
+template <typename T>
+class task
+{
+public:
+    using promise_type = detail::Promise<T>;
+    using Handle = std::coroutine_handle<promise_type>;
+
+    task() = default;
+    explicit task(Handle h) : mHandle(h) {}
+    task(task &&other) noexcept : mHandle(std::exchange(other.mHandle, nullptr)) {}
+    task& operator=(task &&other) noexcept
+    {
+        if (this != &other)
+        {
+            destroy();
+            mHandle = std::exchange(other.mHandle, nullptr);
+        }
+        return *this;
+    }
+    task(const task&) = delete;
+    task& operator=(const task&) = delete;
+    ~task() { destroy(); }
+
+    bool valid(void) const { return static_cast<bool>(mHandle); }
+
+    // Starts the task and resumes the awaiting coroutine with its result once it finishes
+    auto operator co_await() const noexcept
+    {
+        struct Awaiter
+        {
+            Handle h;
+
+            bool await_ready(void) const noexcept { return h.done(); }
+
+            std::coroutine_handle<> await_suspend(std::coroutine_handle<> caller) noexcept
+            {
+                h.promise().mContinuation = caller;
+                return h;
+            }
+
+            T await_resume(void) { return h.promise().result(); }
+        };
+        return Awaiter{mHandle};
+    }
+
+private:
+    Handle mHandle;
+
+    void destroy(void)
+    {
+        if (mHandle)
+        {
+            std::exchange(mHandle, nullptr).destroy();
+        }
+    }
+};
+
+namespace detail
+{
+
+template <typename T>
+task<T> Promise<T>::get_return_object(void)
+{
+    return task<T>(std::coroutine_handle<Promise<T>>::from_promise(*this));
+}
+
+inline task<void> Promise<void>::get_return_object(void)
+{
+    return task<void>(std::coroutine_handle<Promise<void>>::from_promise(*this));
+}
+
+} // namespace detail
+
+// Awaitable that moves the coroutine onto the pool, after an optional delay
+class ScheduleAwaiter
+{
+public:
+    ScheduleAwaiter(taskQueue &pool, std::optional<std::chrono::steady_clock::duration> delay)
+        : mPool(pool), mDelay(delay) {}
+
+    bool await_ready(void) const noexcept { return false; }
+
+    // noexcept: if queueing the resume step fails there is no way to both resume the
+    // coroutine and report the error, so running out of memory here terminates
+    void await_suspend(std::coroutine_handle<> h) noexcept
+    {
+        InlineTask step(detail::Resume(h, &mCancelled));
+        if (mDelay)
+        {
+            mPool.post_after(*mDelay, std::move(step));
+        }
+        else
+        {
+            mPool.post(std::move(step));
+        }
+    }
+
+    void await_resume(void) const
+    {
+        if (mCancelled)
+        {
+            throw std::runtime_error("taskQueue shut down before the coroutine could resume");
+        }
+    }
+
+private:
+    taskQueue &mPool;
+    std::optional<std::chrono::steady_clock::duration> mDelay;
+    bool mCancelled = false;
+};
+
+inline ScheduleAwaiter schedule(taskQueue &pool)
+{
+    return ScheduleAwaiter(pool, std::nullopt);
+}
+
+template <typename Rep, typename Period>
+ScheduleAwaiter sleep_for(taskQueue &pool, std::chrono::duration<Rep, Period> delay)
+{
+    return ScheduleAwaiter(pool, std::chrono::duration_cast<std::chrono::steady_clock::duration>(delay));
+}
+
+namespace detail
+{
+
+template <typename T>
+Detached drive(taskQueue &pool, task<T> t, TaskState<T> *state)
+{
+    try
+    {
+        co_await schedule(pool);
+        if constexpr (std::is_void_v<T>)
+        {
+            co_await t;
+            state->setValue();
+        }
+        else
+        {
+            state->setValue(co_await t);
+        }
+    }
+    catch (...)
+    {
+        state->setException(std::current_exception());
+    }
+}
+
+} // namespace detail
+
+// Runs t on the pool and returns a future for its result
+template <typename T>
+TaskFuture<T> spawn(taskQueue &pool, task<T> t)
+{
+    if (!pool.running())
+    {
+        throw std::runtime_error("Attempting to spawn when taskQueue is not running");
+    }
+    TaskState<T> *state = TaskState<T>::acquire(pool.scheduler());
+    TaskFuture<T> f(state);
+    detail::drive(pool, std::move(t), state);
+    return f;
+}
+
+} // namespace coro
+
+#endif
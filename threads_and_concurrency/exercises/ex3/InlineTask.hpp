@@ -0,0 +1,117 @@
+#ifndef INLINE_TASK_HPP
+#define INLINE_TASK_HPP
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+// Move-only void() callable with CAPACITY bytes of in-object storage. A small lambda plus
+// its captures is stored inline, so wrapping it costs no heap allocation the way
+// std::function can; anything larger, or not nothrow-movable, falls back to the heap.
+// Unlike std::function it accepts move-only callables such as std::packaged_task.
+class InlineTask
+{
+public:
+    static constexpr size_t CAPACITY = 48;
+
+    InlineTask() noexcept = default;
+
+    template <typename F>
+        requires (!std::is_same_v<std::decay_t<F>, InlineTask> && std::is_invocable_v<std::decay_t<F>&>)
+    InlineTask(F &&f)
+    {
+        using Fn = std::decay_t<F>;
+        if constexpr (fitsInline<Fn>())
+        {
+            new (mBuf) Fn(std::forward<F>(f));
+            mOps = &inlineOps<Fn>;
+        }
+        else
+        {
+            *reinterpret_cast<Fn**>(mBuf) = new Fn(std::forward<F>(f));
+            mOps = &heapOps<Fn>;
+        }
+    }
+
+    InlineTask(InlineTask &&other) noexcept
+    {
+        moveFrom(other);
+    }
+
+    InlineTask& operator=(InlineTask &&other) noexcept
+    {
+        if (this != &other)
+        {
+            reset();
+            moveFrom(other);
+        }
+        return *this;
+    }
+
+    InlineTask(const InlineTask&) = delete;
+    InlineTask& operator=(const InlineTask&) = delete;
+
+    ~InlineTask() { reset(); }
+
+    void operator()() { mOps->invoke(mBuf); }
+
+    explicit operator bool() const { return mOps != nullptr; }
+
+    void reset(void)
+    {
+        if (mOps)
+        {
+            mOps->destroy(mBuf);
+            mOps = nullptr;
+        }
+    }
+
+private:
+    struct Ops
+    {
+        void (*invoke)(void *self);
+        void (*move)(void *dst, void *src) noexcept;   // move-constructs dst, destroys src
+        void (*destroy)(void *self) noexcept;
+    };
+
+    alignas(std::max_align_t) std::byte mBuf[CAPACITY];
+    const Ops *mOps = nullptr;
+
+    template <typename Fn>
+    static constexpr bool fitsInline(void)
+    {
+        return sizeof(Fn) <= CAPACITY && alignof(Fn) <= alignof(std::max_align_t) &&
+               std::is_nothrow_move_constructible_v<Fn>;
+    }
+
+    template <typename Fn>
+    static constexpr Ops inlineOps = {
+        [](void *self) { (*std::launder(static_cast<Fn*>(self)))(); },
+        [](void *dst, void *src) noexcept
+        {
+            Fn *from = std::launder(static_cast<Fn*>(src));
+            new (dst) Fn(std::move(*from));
+            from->~Fn();
+        },
+        [](void *self) noexcept { std::launder(static_cast<Fn*>(self))->~Fn(); },
+    };
+
+    template <typename Fn>
+    static constexpr Ops heapOps = {
+        [](void *self) { (**static_cast<Fn**>(self))(); },
+        [](void *dst, void *src) noexcept { *static_cast<Fn**>(dst) = *static_cast<Fn**>(src); },
+        [](void *self) noexcept { delete *static_cast<Fn**>(self); },
+    };
+
+    void moveFrom(InlineTask &other) noexcept
+    {
+        if (other.mOps)
+        {
+            other.mOps->move(mBuf, other.mBuf);
+            mOps = std::exchange(other.mOps, nullptr);
+        }
+    }
+};
+
+#endif
@@ -0,0 +1,536 @@
+#ifndef TASK_FUTURE_HPP
+#define TASK_FUTURE_HPP
+
+#include <atomic>
+#include <climits>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include <vector>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include "InlineTask.hpp"
+
+// Future/promise pair for taskQueue::submit. std::future allocates its shared state on
+// every call; TaskState objects instead come from a small per-thread, per-result-type free
+// list, so once a thread has warmed up its cache a submit/get round trip allocates nothing.
+// A state goes back to the cache of the thread that drops the future, normally the one
+// that submitted the task.
+//
+// Instead of blocking in get(), a future can be given a continuation with then(), or be
+// combined with others through when_all and when_any. A continuation is handed to the
+// scheduler of the state it waits on, so for taskQueue futures it runs on the pool and no
+// thread is parked waiting for the result.
+
+// Where continuations go once their input is ready; taskQueue queues them on its workers.
+// A state without a scheduler runs its continuation on the thread that completes it.
+// owner, if set, keeps ctx alive for as long as any state holds the scheduler.
+struct TaskScheduler
+{
+    void (*schedule)(void *ctx, InlineTask &&task) = nullptr;
+    void *ctx = nullptr;
+    std::shared_ptr<void> owner;
+
+    // By value, so a task run in place no longer lives in the state that held it
+    void operator()(InlineTask task) const
+    {
+        if (schedule)
+        {
+            schedule(ctx, std::move(task));
+        }
+        else
+        {
+            task();
+        }
+    }
+};
+
+template <typename R>
+class TaskState
+{
+public:
+    using Value = std::conditional_t<std::is_void_v<R>, std::monostate, R>;
+
+    static TaskState* acquire(const TaskScheduler &scheduler = {})
+    {
+        auto &cache = freeList();
+        TaskState *s;
+        if (!cache.states.empty())
+        {
+            s = cache.states.back();
+            cache.states.pop_back();
+        }
+        else
+        {
+            s = new TaskState;
+        }
+        s->mScheduler = scheduler;
+        return s;
+    }
+
+    const TaskScheduler& scheduler(void) const { return mScheduler; }
+
+    // Called by the future's owner in place of waiting. The continuation owns the future,
+    // so it takes over releasing the state; it is scheduled as soon as the result is set,
+    // or right away if it already is.
+    void setContinuation(InlineTask &&continuation)
+    {
+        mContinuation = std::move(continuation);
+        uint32_t expected = EMPTY;
+        if (!mWord.compare_exchange_strong(expected, CONTINUED, std::memory_order_acq_rel))
+        {
+            dispatchContinuation();
+        }
+    }
+
+    // Called by a future that is done with the state. If the job has not finished yet it
+    // recycles the state itself once it has.
+    void release(void)
+    {
+        if (mWord.exchange(DETACHED, std::memory_order_acq_rel) == READY)
+        {
+            recycle();
+        }
+    }
+
+    // Called by the job exactly once; it must not touch the state afterwards
+    template <typename... V>
+    void setValue(V&&... v)
+    {
+        mValue.emplace(std::forward<V>(v)...);
+        publish();
+    }
+
+    void setException(std::exception_ptr e)
+    {
+        mError = std::move(e);
+        publish();
+    }
+
+    bool isReady(void) const { return mWord.load(std::memory_order_acquire) == READY; }
+
+    void wait(void)
+    {
+        // Sleep on the state word itself. WAITING tells publish() a wake syscall is needed,
+        // so a result that is ready before anyone waits costs no syscall at all.
+        uint32_t seen = mWord.load(std::memory_order_acquire);
+        while (seen != READY)
+        {
+            if (seen == EMPTY && !mWord.compare_exchange_weak(seen, WAITING, std::memory_order_acquire))
+            {
+                continue;
+            }
+            ::syscall(SYS_futex, reinterpret_cast<uint32_t*>(&mWord), FUTEX_WAIT_PRIVATE, WAITING, nullptr, nullptr, 0);
+            seen = mWord.load(std::memory_order_acquire);
+        }
+    }
+
+    R take(void)
+    {
+        static_assert(!std::is_reference_v<R>, "tasks returning references are not supported");
+        wait();
+        if (mError)
+        {
+            std::rethrow_exception(mError);
+        }
+        if constexpr (!std::is_void_v<R>)
+        {
+            return std::move(*mValue);
+        }
+    }
+
+private:
+    static constexpr size_t MAX_CACHED = 256;
+    // The future waits EMPTY -> WAITING or hands over a continuation EMPTY -> CONTINUED,
+    // the job publishes -> READY, and whichever side comes second after the future let go
+    // (-> DETACHED) recycles the state
+    static constexpr uint32_t EMPTY = 0;
+    static constexpr uint32_t WAITING = 1;
+    static constexpr uint32_t READY = 2;
+    static constexpr uint32_t DETACHED = 3;
+    static constexpr uint32_t CONTINUED = 4;
+
+    struct Cache
+    {
+        Cache() { states.reserve(MAX_CACHED); }
+        ~Cache()
+        {
+            for (TaskState *s : states)
+            {
+                delete s;
+            }
+        }
+        std::vector<TaskState*> states;
+    };
+
+    static Cache& freeList(void)
+    {
+        thread_local Cache cache;
+        return cache;
+    }
+
+    std::atomic<uint32_t> mWord{EMPTY};
+    std::optional<Value> mValue;
+    std::exception_ptr mError;
+    TaskScheduler mScheduler;
+    InlineTask mContinuation;
+
+    void dispatchContinuation(void)
+    {
+        // Move it out first: running it may release, and so recycle, this state, and a
+        // continuation set on the recycled state would overwrite the one still running
+        InlineTask task = std::move(mContinuation);
+        TaskScheduler scheduler = mScheduler;
+        scheduler(std::move(task));
+    }
+
+    void recycle(void)
+    {
+        mValue.reset();
+        mError = nullptr;
+        mScheduler = {};
+        mWord.store(EMPTY, std::memory_order_relaxed);
+        auto &cache = freeList();
+        if (cache.states.size() < MAX_CACHED)
+        {
+            cache.states.push_back(this);
+        }
+        else
+        {
+            delete this;
+        }
+    }
+
+    void publish(void)
+    {
+        uint32_t prev = mWord.exchange(READY, std::memory_order_acq_rel);
+        if (prev == DETACHED)
+        {
+            // Nobody will read the result
+            recycle();
+        }
+        else if (prev == CONTINUED)
+        {
+            dispatchContinuation();
+        }
+        else if (prev == WAITING)
+        {
+            // Once READY is stored the future may recycle the state. The wake only uses its
+            // address, so at worst it wakes a later waiter on the same state spuriously.
+            ::syscall(SYS_futex, reinterpret_cast<uint32_t*>(&mWord), FUTEX_WAKE_PRIVATE, INT_MAX, nullptr, nullptr, 0);
+        }
+    }
+};
+
+// Move-only handle to a task's result, like std::future<R>
+template <typename R>
+class TaskFuture
+{
+public:
+    TaskFuture() = default;
+    explicit TaskFuture(TaskState<R> *state) : mState(state) {}
+    TaskFuture(TaskFuture &&other) noexcept : mState(std::exchange(other.mState, nullptr)) {}
+    TaskFuture& operator=(TaskFuture &&other) noexcept
+    {
+        if (this != &other)
+        {
+            reset();
+            mState = std::exchange(other.mState, nullptr);
+        }
+        return *this;
+    }
+    TaskFuture(const TaskFuture&) = delete;
+    TaskFuture& operator=(const TaskFuture&) = delete;
+    ~TaskFuture() { reset(); }
+
+    bool valid(void) const { return mState != nullptr; }
+    // Like every member but valid(), these throw no_state on a moved-from or consumed future
+    bool ready(void) const { return validState()->isReady(); }
+    void wait(void) const { validState()->wait(); }
+
+    // Blocks until the task ran, then returns its result or rethrows its exception.
+    // Like std::future::get it can only be called once.
+    R get(void)
+    {
+        validState();
+        struct Release
+        {
+            TaskFuture *f;
+            ~Release() { f->reset(); }
+        } release{this};
+        return mState->take();
+    }
+
+    // Runs fn(result) on the pool once this future is ready and returns the future of
+    // fn's result; fn takes no argument for a TaskFuture<void>. An exception from the task
+    // skips fn and is passed on to the returned future. Consumes this future.
+    template <typename Fn>
+    auto then(Fn &&fn) &&;
+
+    // Hands this future, once ready, to fn(TaskFuture<R>&&) on the state's scheduler.
+    // Consumes this future; the building block of then, when_all and when_any.
+    template <typename Fn>
+    void onReady(Fn &&fn) &&
+    {
+        TaskState<R> *state = validState();
+        state->setContinuation(InlineTask(
+            [ready = std::move(*this), fn = std::decay_t<Fn>(std::forward<Fn>(fn))]() mutable { fn(std::move(ready)); }));
+    }
+
+    const TaskScheduler& scheduler(void) const { return validState()->scheduler(); }
+
+private:
+    TaskState<R> *mState = nullptr;
+
+    TaskState<R>* validState(void) const
+    {
+        if (!mState)
+        {
+            throw std::future_error(std::future_errc::no_state);
+        }
+        return mState;
+    }
+
+    void reset(void)
+    {
+        if (mState)
+        {
+            std::exchange(mState, nullptr)->release();
+        }
+    }
+};
+
+// What submit stores in a worker's deque: the callable, its bound arguments and the state
+// to fulfil. A job that is destroyed without having run (non-graceful shutdown) breaks
+// its promise, as an unrun std::packaged_task does.
+template <typename R, typename F, typename... Args>
+class TaskJob
+{
+public:
+    TaskJob(TaskState<R> *state, F &&f, std::tuple<Args...> &&args)
+        : mFunc(std::move(f)), mArgs(std::move(args)), mState(state) {}
+
+    TaskJob(TaskJob &&other) noexcept(std::is_nothrow_move_constructible_v<F> &&
+                                      std::is_nothrow_move_constructible_v<std::tuple<Args...>>)
+        : mFunc(std::move(other.mFunc)), mArgs(std::move(other.mArgs)), mState(std::exchange(other.mState, nullptr)) {}
+
+    TaskJob(const TaskJob&) = delete;
+    TaskJob& operator=(const TaskJob&) = delete;
+    TaskJob& operator=(TaskJob&&) = delete;
+
+    ~TaskJob()
+    {
+        if (mState)
+        {
+            std::exchange(mState, nullptr)->setException(
+                std::make_exception_ptr(std::future_error(std::future_errc::broken_promise)));
+        }
+    }
+
+    void operator()()
+    {
+        TaskState<R> *state = std::exchange(mState, nullptr);
+        try
+        {
+            if constexpr (std::is_void_v<R>)
+            {
+                std::apply(mFunc, std::move(mArgs));
+                state->setValue();
+            }
+            else
+            {
+                state->setValue(std::apply(mFunc, std::move(mArgs)));
+            }
+        }
+        catch (...)
+        {
+            state->setException(std::current_exception());
+        }
+    }
+
+private:
+    F mFunc;
+    std::tuple<Args...> mArgs;
+    TaskState<R> *mState;
+};
+
+template <typename R>
+template <typename Fn>
+auto TaskFuture<R>::then(Fn &&fn) &&
+{
+    using F = std::decay_t<Fn>;
+    using U = typename std::conditional_t<std::is_void_v<R>, std::invoke_result<F>, std::invoke_result<F, R>>::type;
+    struct Step
+    {
+        F fn;
+        U operator()(TaskFuture<R> &&ready)
+        {
+            if constexpr (std::is_void_v<R>)
+            {
+                ready.get();
+                return std::invoke(fn);
+            }
+            else
+            {
+                return std::invoke(fn, ready.get());
+            }
+        }
+    };
+    TaskState<R> *state = validState();
+    TaskState<U> *next = TaskState<U>::acquire(state->scheduler());
+    TaskFuture<U> result(next);
+    // A TaskJob, so that a continuation dropped by a non-graceful shutdown breaks its promise
+    state->setContinuation(InlineTask(TaskJob<U, Step, TaskFuture<R>>(
+        next, Step{F(std::forward<Fn>(fn))}, std::tuple<TaskFuture<R>>(std::move(*this)))));
+    return result;
+}
+
+// Becomes ready once every input is, holding the inputs (all ready, get() will not block)
+// in their original order. The inputs are consumed.
+template <typename R>
+TaskFuture<std::vector<TaskFuture<R>>> when_all(std::vector<TaskFuture<R>> futures)
+{
+    using V = std::vector<TaskFuture<R>>;
+    TaskState<V> *state = TaskState<V>::acquire(futures.empty() ? TaskScheduler{} : futures.front().scheduler());
+    TaskFuture<V> result(state);
+    if (futures.empty())
+    {
+        state->setValue();
+        return result;
+    }
+
+    struct Join
+    {
+        V ready;
+        std::atomic<size_t> remaining;
+        TaskState<V> *state;
+
+        ~Join()
+        {
+            // Some input's continuation was dropped without running
+            if (state)
+            {
+                state->setException(std::make_exception_ptr(std::future_error(std::future_errc::broken_promise)));
+            }
+        }
+    };
+    auto join = std::make_shared<Join>();
+    join->ready.resize(futures.size());
+    join->remaining.store(futures.size(), std::memory_order_relaxed);
+    join->state = state;
+    for (size_t i = 0; i < futures.size(); ++i)
+    {
+        std::move(futures[i]).onReady([join, i](TaskFuture<R> &&ready)
+        {
+            join->ready[i] = std::move(ready);
+            if (join->remaining.fetch_sub(1, std::memory_order_acq_rel) == 1)
+            {
+                std::exchange(join->state, nullptr)->setValue(std::move(join->ready));
+            }
+        });
+    }
+    return result;
+}
+
+// Heterogeneous form: when_all(a, b, c) gives a future of tuple<TaskFuture<A>, ...>
+template <typename... R>
+TaskFuture<std::tuple<TaskFuture<R>...>> when_all(TaskFuture<R>&&... futures)
+{
+    using V = std::tuple<TaskFuture<R>...>;
+    static_assert(sizeof...(R) > 0, "when_all needs at least one future");
+    TaskScheduler scheduler = std::get<0>(std::forward_as_tuple(futures...)).scheduler();
+    TaskState<V> *state = TaskState<V>::acquire(scheduler);
+    TaskFuture<V> result(state);
+
+    struct Join
+    {
+        V ready;
+        std::atomic<size_t> remaining{sizeof...(R)};
+        TaskState<V> *state;
+
+        ~Join()
+        {
+            if (state)
+            {
+                state->setException(std::make_exception_ptr(std::future_error(std::future_errc::broken_promise)));
+            }
+        }
+    };
+    auto join = std::make_shared<Join>();
+    join->state = state;
+    auto attach = [&join]<size_t I, typename T>(std::integral_constant<size_t, I>, TaskFuture<T> &&future)
+    {
+        std::move(future).onReady([join](TaskFuture<T> &&ready)
+        {
+            std::get<I>(join->ready) = std::move(ready);
+            if (join->remaining.fetch_sub(1, std::memory_order_acq_rel) == 1)
+            {
+                std::exchange(join->state, nullptr)->setValue(std::move(join->ready));
+            }
+        });
+    };
+    [&]<size_t... I>(std::index_sequence<I...>)
+    {
+        (attach(std::integral_constant<size_t, I>{}, std::move(futures)), ...);
+    }(std::index_sequence_for<R...>{});
+    return result;
+}
+
+template <typename R>
+struct WhenAny
+{
+    size_t index;             // position of the first input to finish
+    TaskFuture<R> future;     // that input, ready
+};
+
+// Becomes ready with the first input to finish; the results of the others are dropped.
+// The inputs are consumed. For handling every result as soon as it is ready, give each
+// future its own then() instead.
+template <typename R>
+TaskFuture<WhenAny<R>> when_any(std::vector<TaskFuture<R>> futures)
+{
+    if (futures.empty())
+    {
+        throw std::runtime_error("when_any needs at least one future");
+    }
+    TaskState<WhenAny<R>> *state = TaskState<WhenAny<R>>::acquire(futures.front().scheduler());
+    TaskFuture<WhenAny<R>> result(state);
+
+    struct Race
+    {
+        std::atomic<bool> won{false};
+        TaskState<WhenAny<R>> *state;
+
+        ~Race()
+        {
+            if (state)
+            {
+                state->setException(std::make_exception_ptr(std::future_error(std::future_errc::broken_promise)));
+            }
+        }
+    };
+    auto race = std::make_shared<Race>();
+    race->state = state;
+    for (size_t i = 0; i < futures.size(); ++i)
+    {
+        std::move(futures[i]).onReady([race, i](TaskFuture<R> &&ready)
+        {
+            if (!race->won.exchange(true, std::memory_order_acq_rel))
+            {
+                std::exchange(race->state, nullptr)->setValue(WhenAny<R>{i, std::move(ready)});
+            }
+        });
+    }
+    return result;
+}
+
+#endif
@@ -0,0 +1,104 @@
+#include <iostream>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+#include "CoTask.hpp"
+
+// Simulated I/O-bound operations on a small pool: each one waits STEPS times for IO_WAIT
+// (standing in for a network round trip) and does a little work in between. As
+// coroutines the waits are timers and no worker is held; as plain tasks each wait blocks
+// a worker in sleep_for. Prints wall time and operations per second for each.
+
+using namespace std::chrono;
+
+const size_t WORKERS = 4;
+const int STEPS = 3;
+const auto IO_WAIT = milliseconds(5);
+const size_t CORO_OPS[] = {1000, 10000, 50000};
+const size_t BLOCKING_OPS = 400;
+
+unsigned compute(unsigned x)
+{
+    for (int i = 0; i < 100; ++i)
+    {
+        x = x * 1664525u + 1013904223u;
+    }
+    return x;
+}
+
+coro::task<unsigned> ioStep(taskQueue &pool, unsigned x)
+{
+    co_await coro::sleep_for(pool, IO_WAIT);
+    co_return compute(x);
+}
+
+coro::task<unsigned> operation(taskQueue &pool, unsigned seed)
+{
+    unsigned x = seed;
+    for (int s = 0; s < STEPS; ++s)
+    {
+        x = co_await ioStep(pool, x);
+    }
+    co_return x;
+}
+
+unsigned blockingOperation(unsigned seed)
+{
+    unsigned x = seed;
+    for (int s = 0; s < STEPS; ++s)
+    {
+        std::this_thread::sleep_for(IO_WAIT);
+        x = compute(x);
+    }
+    return x;
+}
+
+void report(const std::string &mode, size_t ops, double secs)
+{
+    std::cout << mode << ',' << ops << ',' << WORKERS << ',' << secs * 1000 << ',' << static_cast<uint64_t>(ops / secs)
+              << '\n';
+}
+
+int main(void)
+{
+    std::cout << "mode,ops,workers,wall_ms,ops_per_s\n";
+    unsigned sink = 0;
+    for (size_t ops : CORO_OPS)
+    {
+        taskQueue pool(true, WORKERS, false);
+        std::vector<TaskFuture<unsigned>> results;
+        results.reserve(ops);
+        auto start = steady_clock::now();
+        for (size_t i = 0; i < ops; ++i)
+        {
+            results.push_back(coro::spawn(pool, operation(pool, static_cast<unsigned>(i))));
+        }
+        for (auto &r : results)
+        {
+            sink += r.get();
+        }
+        report("coroutine", ops, duration<double>(steady_clock::now() - start).count());
+    }
+
+    {
+        taskQueue pool(true, WORKERS, false);
+        std::vector<TaskFuture<unsigned>> results;
+        auto start = steady_clock::now();
+        for (size_t i = 0; i < BLOCKING_OPS; ++i)
+        {
+            results.push_back(pool.submit(blockingOperation, static_cast<unsigned>(i)));
+        }
+        for (auto &r : results)
+        {
+            sink += r.get();
+        }
+        report("blocking_task", BLOCKING_OPS, duration<double>(steady_clock::now() - start).count());
+    }
+
+    if (sink == 1)
+    {
+        std::cout << sink;
+    }
+    return 0;
+}
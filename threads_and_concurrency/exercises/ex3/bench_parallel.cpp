@@ -0,0 +1,102 @@
+#include <iostream>
+#include <chrono>
+#include <cmath>
+#include <string>
+#include <vector>
+#include "taskQueue.hpp"
+
+// Cost of a data-parallel loop over ELEMENTS items run on the pool: one submit per
+// element, one submit_bulk of per-element tasks, parallel_for and parallel_reduce with
+// automatic chunking, against a plain serial loop. Prints ns per element per worker count,
+// best of REPEATS runs since a single pass over a few milliseconds is easily disturbed.
+
+using namespace std::chrono;
+
+const size_t ELEMENTS = 1000000;
+const int REPEATS = 3;
+
+double work(size_t i)
+{
+    return std::sqrt(static_cast<double>(i)) * 0.5;
+}
+
+template <typename Body>
+double nsPerElement(Body body)
+{
+    double best = 0;
+    for (int r = 0; r < REPEATS; ++r)
+    {
+        auto start = steady_clock::now();
+        body();
+        double ns = duration<double, std::nano>(steady_clock::now() - start).count() / ELEMENTS;
+        best = (r == 0) ? ns : std::min(best, ns);
+    }
+    return best;
+}
+
+void runBenchmark(size_t workers)
+{
+    taskQueue pool(true, workers, false);
+    std::vector<double> out(ELEMENTS);
+
+    double serial = nsPerElement([&]() {
+        for (size_t i = 0; i < ELEMENTS; ++i)
+        {
+            out[i] = work(i);
+        }
+    });
+
+    double perSubmit = nsPerElement([&]() {
+        std::vector<TaskFuture<void>> futures;
+        futures.reserve(ELEMENTS);
+        for (size_t i = 0; i < ELEMENTS; ++i)
+        {
+            futures.push_back(pool.submit([&out, i]() { out[i] = work(i); }));
+        }
+        for (auto &f : futures)
+        {
+            f.get();
+        }
+    });
+
+    double bulk = nsPerElement([&]() {
+        auto futures = pool.submit_bulk(std::views::iota(size_t(0), ELEMENTS) |
+                                        std::views::transform([&out](size_t i) { return [&out, i]() { out[i] = work(i); }; }));
+        for (auto &f : futures)
+        {
+            f.get();
+        }
+    });
+
+    double parallelFor = nsPerElement([&]() {
+        pool.parallel_for(0, ELEMENTS, 0, [&out](size_t i) { out[i] = work(i); });
+    });
+
+    double sum = 0;
+    double parallelReduce = nsPerElement([&]() {
+        sum = pool.parallel_reduce(0, ELEMENTS, 0, 0.0, work, [](double a, double b) { return a + b; });
+    });
+    if (sum < 0)
+    {
+        std::cout << sum;
+    }
+
+    std::cout << workers << ',' << serial << ',' << perSubmit << ',' << bulk << ',' << parallelFor << ','
+              << parallelReduce << '\n';
+}
+
+int main(void)
+{
+    std::cout << "workers,serial_ns,submit_each_ns,submit_bulk_ns,parallel_for_ns,parallel_reduce_ns\n";
+    const size_t maxWorkers = taskQueue::defaultWorkers();
+    for (size_t workers = 1; ; workers *= 2)
+    {
+        workers = std::min(workers, maxWorkers);
+        runBenchmark(workers);
+        if (workers == maxWorkers)
+        {
+            break;
+        }
+    }
+    return 0;
+}
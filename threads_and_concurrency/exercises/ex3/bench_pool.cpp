@@ -0,0 +1,70 @@
+#include <iostream>
+#include <chrono>
+#include <future>
+#include <vector>
+#include "taskQueue.hpp"
+
+// Task throughput of taskQueue from 1 worker up to one per core. Tiny tasks measure the
+// pool's own overhead (submit, steal, wake-up); coarse tasks do ~50 us of arithmetic each
+// and show how well the work spreads over the workers.
+
+using namespace std::chrono;
+
+const size_t TINY_TASKS = 200000;
+const size_t COARSE_TASKS = 4000;
+const unsigned COARSE_ITERATIONS = 50000;
+
+int tinyTask(void)
+{
+    return 1;
+}
+
+int coarseTask(void)
+{
+    unsigned x = 1;
+    for (unsigned i = 0; i < COARSE_ITERATIONS; ++i)
+    {
+        x = x * 1664525u + 1013904223u;
+    }
+    return static_cast<int>(x & 1);
+}
+
+double run(size_t workers, size_t tasks, int (*fn)(void))
+{
+    taskQueue pool(true, workers, false);
+    std::vector<TaskFuture<int>> futures;
+    futures.reserve(tasks);
+    auto start = steady_clock::now();
+    for (size_t i = 0; i < tasks; ++i)
+    {
+        futures.push_back(pool.submit(fn));
+    }
+    long sum = 0;
+    for (auto &f : futures)
+    {
+        sum += f.get();
+    }
+    double secs = duration<double>(steady_clock::now() - start).count();
+    if (sum < 0)
+    {
+        std::cout << sum;
+    }
+    return tasks / secs;
+}
+
+int main(void)
+{
+    std::cout << "workers,tiny_tasks_per_s,coarse_tasks_per_s\n";
+    const size_t maxWorkers = taskQueue::defaultWorkers();
+    for (size_t workers = 1; ; workers *= 2)
+    {
+        workers = std::min(workers, maxWorkers);
+        std::cout << workers << ',' << static_cast<uint64_t>(run(workers, TINY_TASKS, tinyTask)) << ','
+                  << static_cast<uint64_t>(run(workers, COARSE_TASKS, coarseTask)) << '\n';
+        if (workers == maxWorkers)
+        {
+            break;
+        }
+    }
+    return 0;
+}
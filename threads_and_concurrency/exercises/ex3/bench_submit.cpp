@@ -0,0 +1,68 @@
+#include <iostream>
+#include <chrono>
+#include <algorithm>
+#include <functional>
+#include <future>
+#include <string>
+#include <vector>
+#include "taskQueue.hpp"
+#define ALLOC_TRACKER_HOOK_NEW
+#include "../../../perfect_forwarding/AllocTracker.hpp"
+
+// Round-trip latency of one submit followed by get() on a single-worker pool, for the
+// original submit(std::function<int()>) and the templated submit(F&&, Args&&...). Each
+// round trip is timed on its own, so this is latency, not throughput. Heap allocations are
+// counted with AllocTracker and reported per round trip.
+
+using namespace std::chrono;
+
+const size_t WARMUP = 1000;
+const size_t ROUND_TRIPS = 100000;
+
+template <typename SubmitAndGet>
+void runBenchmark(const std::string &name, SubmitAndGet submitAndGet)
+{
+    taskQueue pool(true, 1, false);
+    for (size_t i = 0; i < WARMUP; ++i)
+    {
+        submitAndGet(pool, static_cast<int>(i));
+    }
+
+    std::vector<uint64_t> latencies(ROUND_TRIPS);
+    long sum = 0;
+    alloc_tracking::Scope scope;
+    for (size_t i = 0; i < ROUND_TRIPS; ++i)
+    {
+        auto t0 = steady_clock::now();
+        sum += submitAndGet(pool, static_cast<int>(i));
+        latencies[i] = duration_cast<nanoseconds>(steady_clock::now() - t0).count();
+    }
+    uint64_t allocs = scope.counts().allocations;
+    if (sum < 0)
+    {
+        std::cout << sum;
+    }
+
+    std::sort(latencies.begin(), latencies.end());
+    std::cout << name << ',' << static_cast<double>(allocs) / ROUND_TRIPS << ',' << latencies[ROUND_TRIPS / 2]
+              << ',' << latencies[ROUND_TRIPS * 99 / 100] << ',' << latencies.back() << '\n';
+}
+
+int main(void)
+{
+    std::cout << "submit,allocs_per_task,p50_ns,p99_ns,max_ns\n";
+    runBenchmark("std_function", [](taskQueue &pool, int i) {
+        return pool.submit(std::function<int()>([i]() { return i + 1; })).get();
+    });
+    runBenchmark("templated_lambda", [](taskQueue &pool, int i) {
+        return pool.submit([i]() { return i + 1; }).get();
+    });
+    runBenchmark("templated_args", [](taskQueue &pool, int i) {
+        return pool.submit([](int a, int b) { return a + b; }, i, 1).get();
+    });
+    runBenchmark("templated_void", [](taskQueue &pool, int i) {
+        pool.submit([]() {}).get();
+        return i;
+    });
+    return 0;
+}
@@ -1,13 +1,13 @@
 #include <iostream>
 #include <thread>
 #include <future>
-#include <queue>
 #include <chrono>
-#include <stdexcept>
-#include <csignal>
+#include <vector>
+#include "taskQueue.hpp"
 // Create a tiny worker thread that owns a queue of std::packaged_task<int()>.
 // A submit(std::function<int()>) -> std::future<int> pushes a task and returns its future.
 // Show clean shutdown (poison pill or flag).
+// The queue has since grown into a work-stealing pool, see taskQueue.hpp.
 
 // Improvements to be made
 // mRunning in while loop is not thread safe
@@ -15,136 +15,7 @@
 // Shutdown semantics - do we train tasks or cancel them?
 // Late submissions - API as written allows for submit even after shudtown
 // Replace copy and assignment operators when appropriate
-// Stretch goal: Make submit accept any callable
-
-class taskQueue
-{
-public:
-    taskQueue(bool gracefulExit) : mRunning(true), mGracefulExit(gracefulExit)
-    {
-        runWorkerThread();
-    }
-
-    ~taskQueue()
-    {
-        std::cout << "taskQueue destructor called\n";
-        shutdown();       
-    }
-
-    std::future<int> submit(std::function<int()> func)
-    {
-        {
-            std::unique_lock<std::mutex> lock(mMtx);
-            if (!mRunning)
-            {
-                throw std::runtime_error("Attempting to submit when taskQueue is not running");
-            }
-        }
-
-        std::packaged_task<int()> task(std::move(func));
-        std::future<int> f = task.get_future();
-        std::unique_lock<std::mutex> lock(mMtx);
-        mTaskQueue.push(std::move(task));
-        lock.unlock();
-        mQueueCv.notify_one();
-        std::cout << "Submitted task\n";
-        return f;
-    }
-private:
-    bool mRunning;
-    bool mGracefulExit;
-    std::mutex mMtx;
-    std::condition_variable mQueueCv;
-    std::thread t;
-    std::queue<std::packaged_task<int()>> mTaskQueue;
-    void prepareWorkerExit(void)
-    {
-        if (mGracefulExit)
-        {
-            while (true)
-            {
-                std::unique_lock<std::mutex> lock(mMtx);
-                if (!mTaskQueue.empty())
-                {
-                    auto task = std::move(mTaskQueue.front());
-                    mTaskQueue.pop();
-                    lock.unlock();
-                    std::cout << "Flushing out task to allow gracefull texit\n";
-                    task();
-                }
-                else
-                {
-                    lock.unlock();
-                    std::cout << "No remaining tasks. Exiting gracefully\n";
-                    return;
-                }
-            }
-        }
-        else
-        {
-            std::cout << "Exiting non-gracefully, setting exception indicating promises were broken\n";
-            while (true)
-            {
-                std::unique_lock<std::mutex> lock(mMtx);
-                if (!mTaskQueue.empty())
-                {
-                    while (!mTaskQueue.empty())
-                    {
-                        mTaskQueue.pop();
-                    }
-                    lock.unlock();
-                    std::cout << "Could not complete remaining tasks in queue due to shutdown\n";
-                }
-                else
-                {
-                    lock.unlock();
-                    std::cout << "In non-graceful exit mode, but no remaining tasks. Exiting without throwing\n";
-                    return;
-                }
-            }
-        } 
-    }
-
-    void runWorkerThread(void)
-    {
-         t = std::thread([this](){
-                                     while (true)
-                                     {
-                                         std::unique_lock<std::mutex> lock(mMtx);
-                                         mQueueCv.wait(lock,
-                                                       [this]()
-                                                       { return !mTaskQueue.empty() || !mRunning; });
-                                         if (!mRunning)
-                                         {
-                                             lock.unlock();
-                                             prepareWorkerExit();
-                                             break;
-                                         }
-                                         else
-                                         {
-                                             auto task = std::move(mTaskQueue.front());
-                                             mTaskQueue.pop();
-                                             lock.unlock();
-                                             task();
-                                         }
-                                     }
-                                     std::cout << "Worker thread is exiting\n";
-                                });
-        std::cout << "Worker thread is running\n";
-    }
-
-    void shutdown(void)
-    {
-        {
-            std::unique_lock<std::mutex> lock(mMtx);
-            mRunning = false;
-        }
-        mQueueCv.notify_all();
-        std::cout << "Threads notified to shutdown\n";
-        t.join();
-        std::cout << "Worker thread joined\n";
-    }
-};
+// Stretch goal: Make submit accept any callable (done, see submit(F&&, Args&&...))
 
 int task(void)
 {
@@ -160,16 +31,31 @@ int main(void)
     // true = graceful exit, pop and execute any remaining tasks if queue is non-empty when
     // receving shutdown
     taskQueue taskManager(true);
-    std::vector<std::future<int>> futures;
-    for (int i = 0; i < NUM_TASKS; ++i)
-    { 
-        futures.emplace_back(taskManager.submit(task));
-    }
+    // One lock and one wake-up for the whole batch instead of one per submit
+    std::vector<TaskFuture<int>> futures = taskManager.submit_bulk(std::vector<int (*)(void)>(NUM_TASKS, task));
 
+    // Print each result as soon as its task finishes rather than in submit order, then
+    // sum them in one more continuation; main only blocks once, on the final total
+    std::vector<TaskFuture<int>> printed;
     for (auto &f : futures)
     {
-        std::cout << "Result: " << f.get() << "\n";    
+        printed.push_back(std::move(f).then([](int result)
+        {
+            std::cout << "Result: " << result << "\n";
+            return result;
+        }));
     }
+    TaskFuture<int> total = when_all(std::move(printed)).then([](std::vector<TaskFuture<int>> results)
+    {
+        int sum = 0;
+        for (auto &r : results)
+        {
+            sum += r.get();
+        }
+        return sum;
+    });
+    const int sum = total.get();
+    std::cout << "Total: " << sum << "\n";
 
     return 0;
 }
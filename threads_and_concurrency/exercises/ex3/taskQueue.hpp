@@ -0,0 +1,718 @@
+#ifndef TASK_QUEUE_HPP
+#define TASK_QUEUE_HPP
+
+#include <iostream>
+#include <chrono>
+#include <thread>
+#include <future>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <stdexcept>
+#include <algorithm>
+#include <functional>
+#include <ranges>
+#include <tuple>
+#include <type_traits>
+#include "InlineTask.hpp"
+#include "TaskFuture.hpp"
+
+// Pool of worker threads, each owning a deque of tasks.
+// submit(f, args...) -> TaskFuture<R> queues f(args...) for any callable and result type R.
+// A small callable with its arguments is stored inline in the deque and its result state
+// comes from a per-thread pool, so the round trip does not touch the heap. The original
+// submit(std::function<int()>) -> std::future<int> is still there for existing callers.
+//
+// submit_bulk queues a whole range of callables under one lock with one wake-up.
+// parallel_for and parallel_reduce split an index range into chunks that the calling thread
+// and a few helper tasks claim from a shared counter, so a loop costs a handful of tasks
+// rather than one per element.
+//
+// Futures from submit and submit_bulk take continuations, future.then(fn), and combine
+// through when_all/when_any (TaskFuture.hpp); continuations are queued on this pool.
+//
+// post and post_after queue fire-and-forget tasks, the latter once a delay has passed.
+// Delayed tasks wait in a heap served by a timer thread started on first use; this is
+// what coroutines (CoTask.hpp) sleep on.
+//
+// A worker runs its own tasks newest first and, once its deque is empty, steals the
+// oldest task from another worker, so a burst submitted to one worker spreads over all.
+// Tasks submitted from inside a worker go to that worker's own deque.
+//
+// Shutdown: with gracefulExit every task already submitted still runs; without it the
+// remaining tasks are dropped and their futures report broken_promise. Delayed tasks not
+// yet due are handed to the workers straight away and follow the same rule. Submitting
+// after shutdown has started throws. Futures may outlive the pool: a continuation attached
+// once the workers are gone runs inline with gracefulExit and breaks its promise without.
+
+// Growable circular buffer used as each worker's deque. Unlike std::deque it keeps its
+// storage once grown, so pushing and popping in steady state does not allocate.
+class TaskRing
+{
+public:
+    explicit TaskRing(size_t capacity = 64)
+    {
+        size_t cap = 1;
+        while (cap < capacity)
+        {
+            cap <<= 1;
+        }
+        mSlots = std::make_unique<InlineTask[]>(cap);
+        mMask = cap - 1;
+    }
+
+    bool empty(void) const { return mCount == 0; }
+    size_t size(void) const { return mCount; }
+
+    void push_back(InlineTask &&task)
+    {
+        if (mCount > mMask)
+        {
+            grow();
+        }
+        mSlots[(mHead + mCount) & mMask] = std::move(task);
+        ++mCount;
+    }
+
+    InlineTask pop_back(void)
+    {
+        --mCount;
+        return std::move(mSlots[(mHead + mCount) & mMask]);
+    }
+
+    InlineTask pop_front(void)
+    {
+        InlineTask task = std::move(mSlots[mHead]);
+        mHead = (mHead + 1) & mMask;
+        --mCount;
+        return task;
+    }
+
+private:
+    std::unique_ptr<InlineTask[]> mSlots;
+    size_t mMask = 0;
+    size_t mHead = 0;
+    size_t mCount = 0;
+
+    void grow(void)
+    {
+        const size_t cap = (mMask + 1) * 2;
+        auto slots = std::make_unique<InlineTask[]>(cap);
+        for (size_t i = 0; i < mCount; ++i)
+        {
+            slots[i] = std::move(mSlots[(mHead + i) & mMask]);
+        }
+        mSlots = std::move(slots);
+        mMask = cap - 1;
+        mHead = 0;
+    }
+};
+
+class taskQueue
+{
+public:
+    using Task = InlineTask;
+
+    explicit taskQueue(bool gracefulExit, size_t numWorkers = defaultWorkers(), bool verbose = true)
+        : mRunning(true), mGracefulExit(gracefulExit), mVerbose(verbose)
+    {
+        auto link = std::make_shared<SchedulerLink>();
+        link->pool = this;
+        link->graceful = gracefulExit;
+        mScheduler = TaskScheduler{&scheduleOnPool, link.get(), link};
+        numWorkers = std::max<size_t>(numWorkers, 1);
+        for (size_t i = 0; i < numWorkers; ++i)
+        {
+            mWorkers.push_back(std::make_unique<Worker>());
+        }
+        runWorkerThreads();
+    }
+
+    ~taskQueue()
+    {
+        log("taskQueue destructor called\n");
+        shutdown();
+    }
+
+    taskQueue(const taskQueue&) = delete;
+    taskQueue& operator=(const taskQueue&) = delete;
+
+    std::future<int> submit(std::function<int()> func)
+    {
+        checkRunning();
+        std::packaged_task<int()> task(std::move(func));
+        std::future<int> f = task.get_future();
+        enqueue(Task(std::move(task)));
+        return f;
+    }
+
+    // Arguments are decay-copied (moved when passed as rvalues) like std::async does
+    template <typename F, typename... Args>
+        requires std::is_invocable_v<std::decay_t<F>, std::decay_t<Args>...>
+    auto submit(F &&func, Args&&... args) -> TaskFuture<std::invoke_result_t<std::decay_t<F>, std::decay_t<Args>...>>
+    {
+        using R = std::invoke_result_t<std::decay_t<F>, std::decay_t<Args>...>;
+        using Job = TaskJob<R, std::decay_t<F>, std::decay_t<Args>...>;
+        checkRunning();
+        TaskState<R> *state = TaskState<R>::acquire(scheduler());
+        TaskFuture<R> f(state);
+        enqueue(Task(Job(state, std::decay_t<F>(std::forward<F>(func)),
+                         std::tuple<std::decay_t<Args>...>(std::forward<Args>(args)...))));
+        return f;
+    }
+
+    // Copies (or moves, for a range of prvalues) every callable in the range into one
+    // worker's deque and returns their futures in range order
+    template <std::ranges::input_range Range>
+        requires std::is_invocable_v<std::decay_t<std::ranges::range_reference_t<Range>>>
+    auto submit_bulk(Range &&funcs)
+    {
+        using F = std::decay_t<std::ranges::range_reference_t<Range>>;
+        using R = std::invoke_result_t<F>;
+        using Job = TaskJob<R, F>;
+        checkRunning();
+        std::vector<TaskFuture<R>> futures;
+        if constexpr (std::ranges::sized_range<Range>)
+        {
+            futures.reserve(std::ranges::size(funcs));
+        }
+        enqueueBulk([&](TaskRing &tasks) {
+            for (auto &&func : funcs)
+            {
+                TaskState<R> *state = TaskState<R>::acquire(scheduler());
+                futures.emplace_back(state);
+                tasks.push_back(Task(Job(state, F(std::forward<decltype(func)>(func)), std::tuple<>())));
+            }
+        });
+        return futures;
+    }
+
+    // Calls fn(i) for every i in [first, last) and returns once all calls are done. grain
+    // is the number of indices per chunk, 0 picks one giving a few chunks per worker. The
+    // first exception thrown by fn is rethrown here; chunks not yet started are skipped.
+    template <typename Fn>
+    void parallel_for(size_t first, size_t last, size_t grain, Fn &&fn)
+    {
+        auto chunk = [&fn](size_t lo, size_t hi, size_t)
+        {
+            for (size_t i = lo; i < hi; ++i)
+            {
+                fn(i);
+            }
+        };
+        runChunks(first, last, grain, chunk);
+    }
+
+    // Folds combine(acc, map(i)) over [first, last) starting from identity. Each chunk is
+    // reduced on its own and the partial results are combined in chunk order, so combine
+    // has to be associative but need not be commutative.
+    template <typename T, typename Map, typename Combine>
+    T parallel_reduce(size_t first, size_t last, size_t grain, T identity, Map &&map, Combine &&combine)
+    {
+        if (first >= last)
+        {
+            return identity;
+        }
+        grain = chunkGrain(last - first, grain);
+        std::vector<T> partials((last - first + grain - 1) / grain, identity);
+        auto chunk = [&](size_t lo, size_t hi, size_t index)
+        {
+            T acc = identity;
+            for (size_t i = lo; i < hi; ++i)
+            {
+                acc = combine(std::move(acc), map(i));
+            }
+            partials[index] = std::move(acc);
+        };
+        runChunks(first, last, grain, chunk);
+        T result = std::move(identity);
+        for (T &partial : partials)
+        {
+            result = combine(std::move(result), std::move(partial));
+        }
+        return result;
+    }
+
+    // Queues a task with no future. Unlike submit it does not check that the pool is
+    // running, so work already in flight (continuations, coroutines) can queue its next
+    // step during shutdown.
+    void post(Task &&task)
+    {
+        enqueue(std::move(task));
+    }
+
+    void post_after(std::chrono::steady_clock::duration delay, Task &&task)
+    {
+        const auto due = std::chrono::steady_clock::now() + delay;
+        std::unique_lock<std::mutex> lock(mTimerMtx);
+        if (mTimerStop)
+        {
+            lock.unlock();
+            enqueue(std::move(task));
+            return;
+        }
+        if (!mTimerThread.joinable())
+        {
+            mTimerThread = std::thread([this]() { timerLoop(); });
+        }
+        const bool earliest = mTimers.empty() || due < mTimers.front().due;
+        mTimers.push_back(Timer{due, mTimerSeq++, std::move(task)});
+        std::push_heap(mTimers.begin(), mTimers.end(), laterTimer);
+        if (earliest)
+        {
+            mTimerCv.notify_one();
+        }
+    }
+
+    // Hook for TaskState: continuations of this pool's futures are posted like any task.
+    // Futures may outlive the pool; see SchedulerLink for what happens to them then.
+    const TaskScheduler& scheduler(void) const { return mScheduler; }
+
+    bool running(void) const { return mRunning.load(std::memory_order_acquire); }
+
+    size_t workerCount(void) const { return mWorkers.size(); }
+
+    static size_t defaultWorkers(void)
+    {
+        return std::max(1u, std::thread::hardware_concurrency());
+    }
+
+private:
+    // Own line per worker so a thief locking one deque does not slow down its neighbours
+    struct alignas(64) Worker
+    {
+        std::mutex mMtx;
+        TaskRing mTasks;
+        std::thread mThread;
+    };
+
+    // What this pool's futures hold to reach it. shutdown() cuts it once no worker will run
+    // another task; a continuation scheduled after that runs on the thread that completed
+    // its input with a graceful exit, and is otherwise dropped, breaking its promise.
+    struct SchedulerLink
+    {
+        std::mutex mtx;
+        taskQueue *pool;
+        bool graceful;
+    };
+
+    static void scheduleOnPool(void *ctx, InlineTask &&task)
+    {
+        SchedulerLink &link = *static_cast<SchedulerLink*>(ctx);
+        {
+            std::lock_guard<std::mutex> lock(link.mtx);
+            if (link.pool)
+            {
+                link.pool->enqueue(std::move(task));
+                return;
+            }
+        }
+        if (link.graceful)
+        {
+            task();
+        }
+        else
+        {
+            task.reset();   // destroyed unrun, so its promise breaks
+        }
+    }
+
+    std::atomic<bool> mRunning;
+    bool mGracefulExit;
+    bool mVerbose;
+    std::vector<std::unique_ptr<Worker>> mWorkers;
+    TaskScheduler mScheduler;
+    std::atomic<size_t> mNextWorker{0};
+    // Tasks queued but not yet taken, and workers about to sleep or asleep. Sleeping only
+    // happens under mSleepMtx with mPending == 0, see wakeIdle(). mPending is raised under
+    // the deque lock, before the task can be taken, so takeTask never drops it below zero.
+    std::atomic<size_t> mPending{0};
+    std::atomic<size_t> mIdle{0};
+    std::mutex mSleepMtx;
+    std::condition_variable mSleepCv;
+
+    struct Timer
+    {
+        std::chrono::steady_clock::time_point due;
+        uint64_t seq;   // keeps timers with the same deadline in posting order
+        Task task;
+    };
+
+    // Delayed tasks, a min-heap on (due, seq), served by mTimerThread
+    std::vector<Timer> mTimers;
+    uint64_t mTimerSeq = 0;
+    bool mTimerStop = false;
+    std::mutex mTimerMtx;
+    std::condition_variable mTimerCv;
+    std::thread mTimerThread;
+
+    inline static thread_local taskQueue *tlsPool = nullptr;
+    inline static thread_local size_t tlsIndex = 0;
+
+    void log(const char *msg) const
+    {
+        if (mVerbose)
+        {
+            std::cout << msg;
+        }
+    }
+
+    static bool laterTimer(const Timer &a, const Timer &b)
+    {
+        return a.due != b.due ? a.due > b.due : a.seq > b.seq;
+    }
+
+    void timerLoop(void)
+    {
+        std::unique_lock<std::mutex> lock(mTimerMtx);
+        while (!mTimerStop)
+        {
+            if (mTimers.empty())
+            {
+                mTimerCv.wait(lock);
+                continue;
+            }
+            const auto due = mTimers.front().due;
+            if (std::chrono::steady_clock::now() < due)
+            {
+                mTimerCv.wait_until(lock, due);
+                continue;
+            }
+            std::pop_heap(mTimers.begin(), mTimers.end(), laterTimer);
+            Task task = std::move(mTimers.back().task);
+            mTimers.pop_back();
+            lock.unlock();
+            enqueue(std::move(task));
+            lock.lock();
+        }
+    }
+
+    // Stops the timer thread and hands every delayed task to the workers in deadline order
+    void stopTimers(void)
+    {
+        std::vector<Timer> pending;
+        {
+            std::unique_lock<std::mutex> lock(mTimerMtx);
+            mTimerStop = true;
+            pending.swap(mTimers);
+        }
+        mTimerCv.notify_all();
+        if (mTimerThread.joinable())
+        {
+            mTimerThread.join();
+        }
+        std::sort(pending.begin(), pending.end(), [](const Timer &a, const Timer &b) { return laterTimer(b, a); });
+        for (Timer &t : pending)
+        {
+            enqueue(std::move(t.task));
+        }
+    }
+
+    void checkRunning(void) const
+    {
+        if (!mRunning.load(std::memory_order_acquire))
+        {
+            throw std::runtime_error("Attempting to submit when taskQueue is not running");
+        }
+    }
+
+    void enqueue(Task &&task)
+    {
+        Worker &w = *mWorkers[targetWorker()];
+        {
+            std::unique_lock<std::mutex> lock(w.mMtx);
+            w.mTasks.push_back(std::move(task));
+            mPending.fetch_add(1, std::memory_order_seq_cst);
+        }
+        wakeIdle(1);
+        log("Submitted task\n");
+    }
+
+    // fill pushes any number of tasks into one worker's deque under its lock; idle workers
+    // are then woken once for the lot
+    template <typename Fill>
+    void enqueueBulk(Fill &&fill)
+    {
+        Worker &w = *mWorkers[targetWorker()];
+        std::unique_lock<std::mutex> lock(w.mMtx);
+        const size_t before = w.mTasks.size();
+        try
+        {
+            fill(w.mTasks);
+        }
+        catch (...)
+        {
+            // Tasks pushed before the failure are queued and still have to be counted
+            const size_t added = w.mTasks.size() - before;
+            mPending.fetch_add(added, std::memory_order_seq_cst);
+            lock.unlock();
+            if (added > 0)
+            {
+                wakeIdle(added);
+            }
+            throw;
+        }
+        const size_t added = w.mTasks.size() - before;
+        mPending.fetch_add(added, std::memory_order_seq_cst);
+        lock.unlock();
+        if (added > 0)
+        {
+            wakeIdle(added);
+            log("Submitted task batch\n");
+        }
+    }
+
+    // Shared by the caller of runChunks and its helper tasks. Helpers hold it through a
+    // shared_ptr, so one that only starts after the loop has finished still finds it.
+    struct ChunkLoop
+    {
+        size_t first;
+        size_t last;
+        size_t grain;
+        size_t chunks;
+        std::atomic<size_t> next{0};
+        std::atomic<size_t> done{0};
+        std::atomic<bool> failed{false};
+        std::exception_ptr error;
+        std::mutex mtx;
+        std::condition_variable cv;
+    };
+
+    size_t chunkGrain(size_t count, size_t grain) const
+    {
+        if (grain > 0)
+        {
+            return grain;
+        }
+        const size_t targetChunks = mWorkers.size() * 4;
+        return std::max<size_t>(1, (count + targetChunks - 1) / targetChunks);
+    }
+
+    // Claims chunks until none are left. A helper only touches chunk after claiming a valid
+    // index, and the caller waits for every claimed chunk, so chunk may live on its stack.
+    template <typename Chunk>
+    static void drainChunks(ChunkLoop &loop, Chunk &chunk)
+    {
+        size_t index;
+        while ((index = loop.next.fetch_add(1, std::memory_order_relaxed)) < loop.chunks)
+        {
+            if (!loop.failed.load(std::memory_order_relaxed))
+            {
+                const size_t lo = loop.first + index * loop.grain;
+                try
+                {
+                    chunk(lo, std::min(loop.last, lo + loop.grain), index);
+                }
+                catch (...)
+                {
+                    std::lock_guard<std::mutex> lock(loop.mtx);
+                    if (!loop.failed.exchange(true, std::memory_order_relaxed))
+                    {
+                        loop.error = std::current_exception();
+                    }
+                }
+            }
+            if (loop.done.fetch_add(1, std::memory_order_acq_rel) + 1 == loop.chunks)
+            {
+                std::lock_guard<std::mutex> lock(loop.mtx);
+                loop.cv.notify_all();
+            }
+        }
+    }
+
+    template <typename Chunk>
+    void runChunks(size_t first, size_t last, size_t grain, Chunk &chunk)
+    {
+        if (first >= last)
+        {
+            return;
+        }
+        checkRunning();
+        auto loop = std::make_shared<ChunkLoop>();
+        loop->first = first;
+        loop->last = last;
+        loop->grain = chunkGrain(last - first, grain);
+        loop->chunks = (last - first + loop->grain - 1) / loop->grain;
+
+        // The calling thread works through chunks too, so it needs one helper fewer
+        const size_t helpers = std::min(mWorkers.size(), loop->chunks - 1);
+        enqueueBulk([&](TaskRing &tasks) {
+            for (size_t i = 0; i < helpers; ++i)
+            {
+                tasks.push_back(Task([loop, &chunk]() { drainChunks(*loop, chunk); }));
+            }
+        });
+
+        drainChunks(*loop, chunk);
+        {
+            std::unique_lock<std::mutex> lock(loop->mtx);
+            loop->cv.wait(lock, [&]() { return loop->done.load(std::memory_order_acquire) == loop->chunks; });
+        }
+        if (loop->error)
+        {
+            std::rethrow_exception(loop->error);
+        }
+    }
+
+    size_t targetWorker(void)
+    {
+        if (tlsPool == this)
+        {
+            return tlsIndex;
+        }
+        return mNextWorker.fetch_add(1, std::memory_order_relaxed) % mWorkers.size();
+    }
+
+    // Called after count tasks were added to mPending
+    void wakeIdle(size_t count)
+    {
+        // Pairs with the seq_cst mIdle increment in waitForWork: either the sleeper sees
+        // the new tasks, or we see the sleeper and wake it
+        if (mIdle.load(std::memory_order_seq_cst) > 0)
+        {
+            std::lock_guard<std::mutex> lock(mSleepMtx);
+            if (count == 1)
+            {
+                mSleepCv.notify_one();
+            }
+            else
+            {
+                mSleepCv.notify_all();
+            }
+        }
+    }
+
+    // Own deque newest first, then the oldest task of every other worker in turn
+    bool takeTask(size_t self, Task &task)
+    {
+        const size_t n = mWorkers.size();
+        for (size_t k = 0; k < n; ++k)
+        {
+            Worker &w = *mWorkers[(self + k) % n];
+            std::unique_lock<std::mutex> lock(w.mMtx);
+            if (w.mTasks.empty())
+            {
+                continue;
+            }
+            task = (k == 0) ? w.mTasks.pop_back() : w.mTasks.pop_front();
+            mPending.fetch_sub(1, std::memory_order_relaxed);
+            return true;
+        }
+        return false;
+    }
+
+    // Returns false once the pool is shutting down and, for a graceful exit, nothing is left
+    bool waitForWork(void)
+    {
+        mIdle.fetch_add(1, std::memory_order_seq_cst);
+        std::unique_lock<std::mutex> lock(mSleepMtx);
+        mSleepCv.wait(lock, [this]()
+                      { return mPending.load(std::memory_order_seq_cst) > 0 || !mRunning.load(std::memory_order_acquire); });
+        mIdle.fetch_sub(1, std::memory_order_relaxed);
+        if (!mRunning.load(std::memory_order_acquire))
+        {
+            return mGracefulExit && mPending.load(std::memory_order_acquire) > 0;
+        }
+        return true;
+    }
+
+    void workerLoop(size_t self)
+    {
+        tlsPool = this;
+        tlsIndex = self;
+        Task task;
+        while (true)
+        {
+            if (!mRunning.load(std::memory_order_acquire) && !mGracefulExit)
+            {
+                break;
+            }
+            if (takeTask(self, task))
+            {
+                task();
+                task.reset();
+                continue;
+            }
+            if (!waitForWork())
+            {
+                break;
+            }
+        }
+        tlsPool = nullptr;
+    }
+
+    void runWorkerThreads(void)
+    {
+        for (size_t i = 0; i < mWorkers.size(); ++i)
+        {
+            mWorkers[i]->mThread = std::thread([this, i]() { workerLoop(i); });
+        }
+        if (mVerbose)
+        {
+            std::cout << mWorkers.size() << " worker threads are running\n";
+        }
+    }
+
+    void prepareWorkerExit(void)
+    {
+        if (mGracefulExit)
+        {
+            // Workers drain the deques before they exit; this only catches a submit that
+            // raced with shutdown and landed after the last worker left
+            Task task;
+            while (takeTask(0, task))
+            {
+                log("Flushing out task to allow gracefull texit\n");
+                task();
+            }
+            log("No remaining tasks. Exiting gracefully\n");
+            return;
+        }
+        log("Exiting non-gracefully, setting exception indicating promises were broken\n");
+        size_t dropped = 0;
+        Task task;
+        while (takeTask(0, task))
+        {
+            // Destroying an unrun task breaks its promise. That can queue continuations,
+            // so it happens outside the deque lock and they are dropped in turn.
+            task.reset();
+            ++dropped;
+        }
+        if (dropped > 0)
+        {
+            log("Could not complete remaining tasks in queue due to shutdown\n");
+        }
+        else
+        {
+            log("In non-graceful exit mode, but no remaining tasks. Exiting without throwing\n");
+        }
+    }
+
+    void shutdown(void)
+    {
+        {
+            std::unique_lock<std::mutex> lock(mSleepMtx);
+            mRunning.store(false, std::memory_order_release);
+        }
+        stopTimers();
+        mSleepCv.notify_all();
+        log("Threads notified to shutdown\n");
+        for (auto &w : mWorkers)
+        {
+            w->mThread.join();
+        }
+        log("Worker threads joined\n");
+        {
+            // Waits for a continuation being queued right now; the flush below picks it up
+            SchedulerLink &link = *static_cast<SchedulerLink*>(mScheduler.ctx);
+            std::lock_guard<std::mutex> lock(link.mtx);
+            link.pool = nullptr;
+        }
+        prepareWorkerExit();
+    }
+};
+
+#endif